@@ -30,15 +30,49 @@ typedef void (*ActionClientFn)(NeuroClientPtrPtr c, NeuroClientSelectorFn csf, c
 typedef void (*ActionWorkspaceFn)(NeuroIndex ws);
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+static const NeuroActionContext *context_ = NULL;
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+// The window under the pointer might have changed, so the pointer actions that follow ask the X server for it
+static void invalidate_context(void) {
+  context_ = NULL;
+}
+
+static void get_pointer_window_location(NeuroPoint *p, Window *w) {
+  if (!context_) {
+    NeuroSystemGetPointerWindowLocation(p, w);
+    return;
+  }
+  if (p)
+    *p = context_->pointer;
+  if (w)
+    *w = context_->window;
+}
+
+static NeuroClientPtrPtr get_pointed_client(void) {
+  Window w = None;
+  get_pointer_window_location(NULL, &w);
+  return NeuroClientFindWindow(w);
+}
+
+// Windows might have moved under the pointer
+static void end_windows_change(void) {
+  NeuroSystemIgnoreEnterNotify();
+  invalidate_context();
+}
+
 static void process_workspace(const ActionWorkspaceFn awsf, NeuroIndex ws) {
   assert(awsf);
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   awsf(ws);
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  end_windows_change();
 }
 
 static void process_client(const ActionClientFn acf, NeuroClientPtrPtr c, const NeuroClientSelectorFn csf,
@@ -47,10 +81,8 @@ static void process_client(const ActionClientFn acf, NeuroClientPtrPtr c, const
   assert(csf);
   if (!c)
     return;
-  const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   acf(c, csf, data);
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  end_windows_change();
 }
 
 
@@ -255,45 +287,39 @@ void NeuroActionHandlerStopCpuCalc(NeuroArg null_arg) {
 // Layout
 void NeuroActionHandlerChangeLayout(NeuroArg int_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutChange(ws, NEURO_ARG_INT_GET(int_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  end_windows_change();
 }
 
 void NeuroActionHandlerResetLayout(NeuroArg null_arg) {
   (void)null_arg;
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutReset(ws);
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  end_windows_change();
 }
 
 void NeuroActionHandlerToggleLayout(NeuroArg idx_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutToggle(ws, NEURO_ARG_IDX_GET(idx_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  end_windows_change();
 }
 
 void NeuroActionHandlerToggleModLayout(NeuroArg lmod_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutToggleModCurr(ws, NEURO_ARG_LMOD_GET(lmod_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  end_windows_change();
 }
 
 void NeuroActionHandlerIncreaseMasterLayout(NeuroArg int_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutIncreaseMaster(ws, NEURO_ARG_INT_GET(int_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  end_windows_change();
 }
 
 void NeuroActionHandlerResizeMasterLayout(NeuroArg float_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutResizeMaster(ws, NEURO_ARG_FLOAT_GET(float_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  end_windows_change();
 }
 
 // NeuroWorkspace
@@ -313,6 +339,7 @@ void NeuroActionHandlerSelectMonitor(NeuroArg MonitorSelectorFn_arg) {
   NeuroWorkspaceUnfocus(NeuroCoreGetCurrStack());
   NeuroCoreSetCurrStack(ws);
   NeuroWorkspaceFocus(ws);
+  invalidate_context();
 }
 
 void NeuroActionHandlerRestoreLastMinimized(NeuroArg null_arg) {
@@ -340,6 +367,7 @@ void NeuroActionHandlerToggleScratchpad(NeuroArg command_arg) {
       NeuroSystemSpawn(NEURO_ARG_CMD_GET(command_arg), NULL);
     }
   }
+  invalidate_context();
 }
 
 // Curr NeuroClient
@@ -358,6 +386,7 @@ void NeuroActionHandlerSendCurrClient(NeuroArg workspaceSelectorFn_arg) {
   const NeuroIndex ws = NEURO_ARG_WSF_GET(workspaceSelectorFn_arg)() % NeuroCoreGetSize();
   NeuroWorkspaceClientSend(NeuroClientGetFocused(), NeuroClientSelectorSelf, (const void *)&ws);
   // process_client(NeuroWorkspaceClientSend, NeuroClientGetFocused(), NeuroClientSelectorSelf, (const void *)&ws);
+  invalidate_context();
 }
 
 void NeuroActionHandlerKillCurrClient(NeuroArg clientSelectorFn_arg) {
@@ -409,7 +438,7 @@ void NeuroActionHandlerFocusPtrClient(NeuroArg clientSelectorFn_arg) {
 
   // Select the monitor where the pointer is
   NeuroPoint p;
-  NeuroSystemGetPointerWindowLocation(&p, NULL);
+  get_pointer_window_location(&p, NULL);
   const NeuroMonitor *const m = NeuroMonitorFindPointed(&p);
   for (NeuroIndex ws = NeuroCoreGetHeadStack(); ws < NeuroCoreGetSize(); ++ws) {
     if (NeuroCoreStackGetMonitor(ws) == m) {
@@ -421,56 +450,70 @@ void NeuroActionHandlerFocusPtrClient(NeuroArg clientSelectorFn_arg) {
   }
 
   // Focus the client under the pointer
-  process_client(NeuroWorkspaceClientFocus, NeuroClientGetPointedByPointer(), NEURO_ARG_CSF_GET(clientSelectorFn_arg),
+  process_client(NeuroWorkspaceClientFocus, get_pointed_client(), NEURO_ARG_CSF_GET(clientSelectorFn_arg),
       NULL);
 }
 
 void NeuroActionHandlerFreeMovePtrClient(NeuroArg clientSelectorFn_arg) {
   assert(clientSelectorFn_arg.GenericArgFn_.ClientSelectorFn_);
   NeuroArg fsf = (NeuroArg)NEURO_ARG_FSF(NeuroRuleFreeSetterFit);
-  NeuroWorkspaceClientFreeMove(NeuroClientGetPointedByPointer(), NEURO_ARG_CSF_GET(clientSelectorFn_arg),
-      (const void *)&fsf);
-  // process_client(NeuroWorkspaceClientFreeMove, NeuroClientGetPointedByPointer(),
+  NeuroPoint p;
+  get_pointer_window_location(&p, NULL);
+  const NeuroClientDragArg da = { &p, (const void *)&fsf };
+  NeuroWorkspaceClientFreeDragMove(get_pointed_client(), NEURO_ARG_CSF_GET(clientSelectorFn_arg), (const void *)&da);
+  // process_client(NeuroWorkspaceClientFreeDragMove, NeuroClientGetPointedByPointer(),
   //     NEURO_ARG_CSF_GET(clientSelectorFn_arg), (const void *)&fsf);
+  invalidate_context();
 }
 
 void NeuroActionHandlerFreeResizePtrClient(NeuroArg clientSelectorFn_arg) {
   assert(clientSelectorFn_arg.GenericArgFn_.ClientSelectorFn_);
   NeuroArg fsf = (NeuroArg)NEURO_ARG_FSF(NeuroRuleFreeSetterFit);
-  NeuroWorkspaceClientFreeResize(NeuroClientGetPointedByPointer(), NEURO_ARG_CSF_GET(clientSelectorFn_arg),
-      (const void *)&fsf);
-  // process_client(NeuroWorkspaceClientFreeResize, NeuroClientGetPointedByPointer(),
+  NeuroPoint p;
+  get_pointer_window_location(&p, NULL);
+  const NeuroClientDragArg da = { &p, (const void *)&fsf };
+  NeuroWorkspaceClientFreeDragResize(get_pointed_client(), NEURO_ARG_CSF_GET(clientSelectorFn_arg), (const void *)&da);
+  // process_client(NeuroWorkspaceClientFreeDragResize, NeuroClientGetPointedByPointer(),
   //      NEURO_ARG_CSF_GET(clientSelectorFn_arg), (const void *)&fsf);
+  invalidate_context();
 }
 
 void NeuroActionHandlerFloatMovePtrClient(NeuroArg clientSelectorFn_arg) {
   assert(clientSelectorFn_arg.GenericArgFn_.ClientSelectorFn_);
-  NeuroWorkspaceClientFloatMove(NeuroClientGetPointedByPointer(), NEURO_ARG_CSF_GET(clientSelectorFn_arg), NULL);
+  NeuroPoint p;
+  get_pointer_window_location(&p, NULL);
+  const NeuroClientDragArg da = { &p, NULL };
+  NeuroWorkspaceClientFloatMove(get_pointed_client(), NEURO_ARG_CSF_GET(clientSelectorFn_arg), (const void *)&da);
   // process_client(NeuroWorkspaceClientFloatMove, NeuroClientGetPointedByPointer(),
   //     NEURO_ARG_CSF_GET(clientSelectorFn_arg), NULL);
+  invalidate_context();
 }
 
 void NeuroActionHandlerFloatResizePtrClient(NeuroArg clientSelectorFn_arg) {
   assert(clientSelectorFn_arg.GenericArgFn_.ClientSelectorFn_);
-  NeuroWorkspaceClientFloatResize(NeuroClientGetPointedByPointer(), NEURO_ARG_CSF_GET(clientSelectorFn_arg), NULL);
+  NeuroPoint p;
+  get_pointer_window_location(&p, NULL);
+  const NeuroClientDragArg da = { &p, NULL };
+  NeuroWorkspaceClientFloatResize(get_pointed_client(), NEURO_ARG_CSF_GET(clientSelectorFn_arg), (const void *)&da);
   // process_client(NeuroWorkspaceClientFloatResize, NeuroClientGetPointedByPointer(),
   //     NEURO_ARG_CSF_GET(clientSelectorFn_arg), NULL);
+  invalidate_context();
 }
 
 void NeuroActionHandlerToggleFullscreenPtrClient(NeuroArg clientSelectorFn_arg) {
   assert(clientSelectorFn_arg.GenericArgFn_.ClientSelectorFn_);
-  process_client(NeuroWorkspaceClientToggleFullscreen, NeuroClientGetPointedByPointer(),
+  process_client(NeuroWorkspaceClientToggleFullscreen, get_pointed_client(),
       NEURO_ARG_CSF_GET(clientSelectorFn_arg), NULL);
 }
 
 void NeuroActionHandlerFreePtrClient(NeuroArg freeSetterFn_arg) {
   const void *const p = (const void *)&NEURO_ARG_GAF_GET(freeSetterFn_arg);
-  process_client(NeuroWorkspaceClientFree, NeuroClientGetPointedByPointer(), NeuroClientSelectorSelf, p);
+  process_client(NeuroWorkspaceClientFree, get_pointed_client(), NeuroClientSelectorSelf, p);
 }
 
 void NeuroActionHandlerToggleFreePtrClient(NeuroArg freeSetterFn_arg)  {
   const void *const p = (const void *)&NEURO_ARG_GAF_GET(freeSetterFn_arg);
-  process_client(NeuroWorkspaceClientToggleFree, NeuroClientGetPointedByPointer(), NeuroClientSelectorSelf, p);
+  process_client(NeuroWorkspaceClientToggleFree, get_pointed_client(), NeuroClientSelectorSelf, p);
 }
 
 // Util
@@ -483,9 +526,17 @@ void NeuroActionRunAction(const NeuroAction *a, const NeuroMaybeArg *arg) {
     a->handler(a->arg);
 }
 
-void NeuroActionRunActionChain(const NeuroActionChain *ac) {
+// The context (NULL if unknown) is available to the handlers while the chain runs, until an action changes the windows
+void NeuroActionRunActionChain(const NeuroActionChain *ac, const NeuroActionContext *ctx) {
   if (!ac || !ac->action_list)
     return;
+  const NeuroActionContext *const prev = context_;
+  context_ = ctx;
   for (NeuroIndex i = 0U; ac->action_list[ i ]; ++i)
     NeuroActionRunAction(ac->action_list[ i ], &ac->arg);
+  context_ = prev;
+}
+
+const NeuroActionContext *NeuroActionGetContext(void) {
+  return context_;
 }
@@ -168,5 +168,6 @@ void NeuroActionHandlerToggleFreePtrClient(NeuroArg freeSetterFn_arg);
 
 // Run
 void NeuroActionRunAction(const NeuroAction *a, const NeuroMaybeArg *arg);
-void NeuroActionRunActionChain(const NeuroActionChain *ac);
+void NeuroActionRunActionChain(const NeuroActionChain *ac, const NeuroActionContext *ctx);
+const NeuroActionContext *NeuroActionGetContext(void);
 
@@ -18,10 +18,14 @@
 #include "config.h"
 #include "core.h"
 #include "layout.h"
+#include "monitor.h"
 #include "rule.h"
 #include "workspace.h"
 #include "event.h"
 
+// Defines
+#define DRAG_SYNC_TIMEOUT 500UL  // Milliseconds to wait for a sync request answer before resizing anyway
+
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE VARIABLE DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
@@ -29,18 +33,51 @@
 // XMotionUpdaterFn
 typedef void (*XMotionUpdaterFn)(NeuroRectangle *r, const NeuroRectangle *c, int ex, int ey, const NeuroPoint *p);
 
+// ClientDrag (interactive move or resize, driven by the pointer events of the main loop)
+typedef struct ClientDrag ClientDrag;
+struct ClientDrag {
+  Window win;                   // None if there is no drag in progress
+  bool is_float;                // Whether the float region is dragged instead of the client region
+  NeuroRectangle start_region;
+  NeuroPoint start_pointer;
+  XMotionUpdaterFn xmuf;
+  Time interval;                // Minimum time between updates, one monitor refresh
+  Time last_time;
+  bool is_pending;              // Whether the region changed since the last update
+  bool is_outline;              // Whether only an outline is drawn until the button is released
+  NeuroRectangle outline;       // Region the client gets on release, in outline mode
+  NeuroRectangle drawn;         // Outline currently drawn on the root window
+  bool is_drawn;
+  GC gc;
+  XID sync_alarm;               // None if the resize is not paced by the client (_NET_WM_SYNC_REQUEST)
+  int64_t sync_value;           // Counter value the client sets once it has redrawn
+  Time sync_time;               // When the last sync request was sent
+  bool is_sync_waiting;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Number of X requests not sent because they would not change the window
+static NeuroIndex suppressed_requests_ = 0U;
+
+static ClientDrag drag_ = { None, false, { { 0, 0 }, 0, 0 }, { 0, 0 }, NULL, 0UL, 0UL, false, false,
+    { { 0, 0 }, 0, 0 }, { { 0, 0 }, 0, 0 }, false, NULL, None, 0, 0UL, false };
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-static bool is_protocol_delete(Window w) {
+static bool has_protocol(Window w, Atom protocol) {
   Atom *protocols = NULL;
   bool ret = false;
   int n = 0;
   if (XGetWMProtocols(NeuroSystemGetDisplay(), w, &protocols, &n)) {
     for (int i = 0; !ret && i < n; i++)
-      if (protocols[ i ] == NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_DELETEWINDOW))
+      if (protocols[ i ] == protocol)
         ret = true;
     XFree(protocols);
   }
@@ -54,12 +91,12 @@ static bool set_title_atom(NeuroClient *c, Atom atom) {
   if (!tp.nitems)
     return false;
   if (tp.encoding == XA_STRING) {
-    strncpy(c->title, (char *)tp.value, NEURO_NAME_SIZE_MAX);
+    NeuroTypeSetClientTitle(c, (const char *)tp.value);
   } else {
     char **list = NULL;
     int n = 0;
     if (XmbTextPropertyToTextList(NeuroSystemGetDisplay(), &tp, &list, &n) >= Success && n > 0 && list[ 0 ]) {
-      strncpy(c->title, list[ 0 ], NEURO_NAME_SIZE_MAX);
+      NeuroTypeSetClientTitle(c, list[ 0 ]);
       XFreeStringList(list);
     }
   }
@@ -67,30 +104,111 @@ static bool set_title_atom(NeuroClient *c, Atom atom) {
   return true;
 }
 
-static void process_xmotion(NeuroRectangle *r, NeuroIndex ws, const NeuroRectangle *c, const NeuroPoint *p,
-    XMotionUpdaterFn xmuf, Cursor cursor) {
+static void apply_border_color(NeuroClient *c, NeuroColor color) {
+  assert(c);
+  NeuroClientApplied *const a = &c->applied;
+  if (a->is_border_color_valid && a->border_color == color) {
+    ++suppressed_requests_;
+    return;
+  }
+  XSetWindowBorder(NeuroSystemGetDisplay(), c->win, color);
+  a->border_color = color;
+  a->is_border_color_valid = true;
+}
+
+static void apply_border_width(NeuroClient *c, int border_width) {
+  assert(c);
+  NeuroClientApplied *const a = &c->applied;
+  if (a->is_border_width_valid && a->border_width == border_width) {
+    ++suppressed_requests_;
+    return;
+  }
+  XSetWindowBorderWidth(NeuroSystemGetDisplay(), c->win, border_width);
+  a->border_width = border_width;
+  a->is_border_width_valid = true;
+}
+
+static void apply_region(NeuroClient *c, const NeuroRectangle *r) {
+  assert(c);
   assert(r);
+  NeuroClientApplied *const a = &c->applied;
+  if (a->is_region_valid && NeuroGeometryRectangleIsEqual(&a->region, r)) {
+    ++suppressed_requests_;
+    return;
+  }
+  XMoveResizeWindow(NeuroSystemGetDisplay(), c->win, r->p.x, r->p.y, r->w, r->h);
+  memmove(&a->region, r, sizeof(NeuroRectangle));
+  a->is_region_valid = true;
+}
+
+static void apply_buttons_grab(NeuroClient *c, bool is_grabbed) {
   assert(c);
-  assert(p);
+  NeuroClientApplied *const a = &c->applied;
+  if (a->is_buttons_grab_valid && a->is_buttons_grabbed == is_grabbed) {
+    ++suppressed_requests_;
+    return;
+  }
+  if (is_grabbed)
+    NeuroSystemGrabButtons(c->win, NeuroConfigGet()->button_list);
+  else
+    NeuroSystemUngrabButtons(c->win, NeuroConfigGet()->button_list);
+  a->is_buttons_grabbed = is_grabbed;
+  a->is_buttons_grab_valid = true;
+}
 
-  // Grab the pointer and set a cursor
-  if (GrabSuccess != XGrabPointer(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), false,
-      ButtonPressMask|ButtonReleaseMask|PointerMotionMask, GrabModeAsync, GrabModeAsync, None, cursor, CurrentTime))
+// WM_STATE (ICCCM 4.1.3.1) tells pagers and compositors that unmapped clients are only hidden
+static void set_wm_state(const NeuroClient *c, bool is_mapped) {
+  assert(c);
+  const long wm_state[ 2 ] = { is_mapped ? NormalState : IconicState, None };
+  XChangeProperty(NeuroSystemGetDisplay(), c->win, NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_STATE),
+      NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_STATE), 32, PropModeReplace, (const unsigned char *)wm_state, 2);
+}
+
+// Only the fullscreen and hidden states are owned by neurowm, the rest of _NET_WM_STATE is kept from the client cache
+static void apply_net_wm_state(NeuroClient *c, bool is_fullscreen, bool is_hidden) {
+  assert(c);
+  NeuroClientApplied *const a = &c->applied;
+  if (a->is_net_state_valid && a->is_net_fullscreen == is_fullscreen && a->is_net_hidden == is_hidden) {
+    ++suppressed_requests_;
     return;
+  }
 
-  // process until the button is released
-  XEvent ev = { 0 };
-  do {
-    XMaskEvent(NeuroSystemGetDisplay(), ButtonPressMask|ButtonReleaseMask|PointerMotionMask, &ev);
-    if (ev.type == MotionNotify) {
-      xmuf(r, c, ev.xmotion.x, ev.xmotion.y, p);
-      NeuroLayoutRunCurr(ws);
-      NeuroWorkspaceUpdate(ws);
-    }
-  } while (ev.type != ButtonRelease);
+  const NeuroClientInfo *const info = c->info;
+  Atom states[ NEURO_NET_STATES_MAX + 2 ];
+  NeuroIndex size = info->net_states_size;
+  memcpy(states, info->net_states, size*sizeof(Atom));
+  if (is_fullscreen)
+    states[ size++ ] = NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_FULLSCREEN);
+  if (is_hidden)
+    states[ size++ ] = NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_HIDDEN);
+  c->info->net_state_serial = NextRequest(NeuroSystemGetDisplay());
+  XChangeProperty(NeuroSystemGetDisplay(), c->win, NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_STATE), XA_ATOM, 32,
+      PropModeReplace, (const unsigned char *)states, (int)size);
+
+  a->is_net_fullscreen = is_fullscreen;
+  a->is_net_hidden = is_hidden;
+  a->is_net_state_valid = true;
+}
 
-  // Ungrab the pointer
-  XUngrabPointer(NeuroSystemGetDisplay(), CurrentTime);
+// Unmapping a mapped window makes the X server send an UnmapNotify, which must not be taken as a withdrawal
+static void apply_mapped(NeuroClient *c, bool is_mapped) {
+  assert(c);
+  NeuroClientApplied *const a = &c->applied;
+  if (a->is_map_valid && a->is_mapped == is_mapped) {
+    ++suppressed_requests_;
+    return;
+  }
+  if (is_mapped) {
+    XMapWindow(NeuroSystemGetDisplay(), c->win);
+  } else {
+    if (a->is_map_valid && a->is_mapped)
+      ++c->info->ignore_unmaps;
+    XUnmapWindow(NeuroSystemGetDisplay(), c->win);
+  }
+  set_wm_state(c, is_mapped);
+  apply_net_wm_state(c, c->is_fullscreen, !is_mapped);
+  a->is_mapped = is_mapped;
+  a->is_map_valid = true;
 }
 
 static void xmotion_move(NeuroRectangle *r, const NeuroRectangle *c, int ex, int ey, const NeuroPoint *p) {
@@ -104,6 +222,159 @@ static void xmotion_resize(NeuroRectangle *r, const NeuroRectangle *c, int ex, i
   r->h = c->h + (ey - (c->h + r->p.y));
 }
 
+#ifdef XSYNC
+// The alarm fires when the client sets its counter to the value of the last sync request, i.e. once it has redrawn
+static bool start_sync(const NeuroClient *client) {
+  assert(client);
+  XSyncValue value;
+  if (!XSyncQueryCounter(NeuroSystemGetDisplay(), client->info->sync_counter, &value))
+    return false;
+  drag_.sync_value = ((int64_t)XSyncValueHigh32(value) << 32) | (int64_t)XSyncValueLow32(value);
+  XSyncAlarmAttributes attr;
+  attr.trigger.counter = client->info->sync_counter;
+  attr.trigger.value_type = XSyncAbsolute;
+  attr.trigger.wait_value = value;
+  attr.trigger.test_type = XSyncPositiveComparison;
+  XSyncIntToValue(&attr.delta, 0);
+  attr.events = True;
+  drag_.sync_alarm = XSyncCreateAlarm(NeuroSystemGetDisplay(),
+      XSyncCACounter|XSyncCAValueType|XSyncCAValue|XSyncCATestType|XSyncCADelta|XSyncCAEvents, &attr);
+  return drag_.sync_alarm != None;
+}
+
+static void stop_sync(void) {
+  XSyncDestroyAlarm(NeuroSystemGetDisplay(), drag_.sync_alarm);
+  drag_.sync_alarm = None;
+}
+
+static void send_sync_request(Window w, Time time) {
+  drag_.sync_value++;
+  XSyncValue value;
+  XSyncIntsToValue(&value, (unsigned int)(drag_.sync_value & 0xffffffff), (int)(drag_.sync_value >> 32));
+  XSyncAlarmAttributes attr;
+  attr.trigger.wait_value = value;
+  XSyncChangeAlarm(NeuroSystemGetDisplay(), drag_.sync_alarm, XSyncCAValue, &attr);
+
+  XEvent e;
+  memset(&e, 0, sizeof(XEvent));
+  e.xclient.type = ClientMessage;
+  e.xclient.window = w;
+  e.xclient.message_type = NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_PROTOCOLS);
+  e.xclient.format = 32;
+  e.xclient.data.l[ 0 ] = (long)NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_SYNCREQUEST);
+  e.xclient.data.l[ 1 ] = (long)time;
+  e.xclient.data.l[ 2 ] = (long)XSyncValueLow32(value);
+  e.xclient.data.l[ 3 ] = (long)XSyncValueHigh32(value);
+  XSendEvent(NeuroSystemGetDisplay(), w, false, NoEventMask, &e);
+  drag_.sync_time = time;
+  drag_.is_sync_waiting = true;
+}
+#endif
+
+// Drawing the outline again with the inverting GC erases it
+static void draw_outline(const NeuroRectangle *r) {
+  assert(r);
+  if (r->w < 2 || r->h < 2)
+    return;
+  XDrawRectangle(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), drag_.gc, r->p.x, r->p.y, r->w - 1, r->h - 1);
+}
+
+// The server is only grabbed around each erase and draw pair, so other clients keep running during the drag
+static void update_outline(void) {
+  XGrabServer(NeuroSystemGetDisplay());
+  if (drag_.is_drawn)
+    draw_outline(&drag_.drawn);
+  memmove(&drag_.drawn, &drag_.outline, sizeof(NeuroRectangle));
+  draw_outline(&drag_.drawn);
+  XUngrabServer(NeuroSystemGetDisplay());
+  drag_.is_drawn = true;
+}
+
+static bool start_outline(void) {
+  XGCValues gcv;
+  gcv.function = GXinvert;
+  gcv.subwindow_mode = IncludeInferiors;
+  gcv.line_width = 2;
+  drag_.gc = XCreateGC(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), GCFunction|GCSubwindowMode|GCLineWidth, &gcv);
+  if (!drag_.gc)
+    return false;
+  memmove(&drag_.outline, &drag_.start_region, sizeof(NeuroRectangle));
+  drag_.is_drawn = false;
+  update_outline();
+  return true;
+}
+
+static void stop_outline(void) {
+  if (drag_.is_drawn)
+    draw_outline(&drag_.drawn);
+  drag_.is_drawn = false;
+  XFreeGC(NeuroSystemGetDisplay(), drag_.gc);
+  drag_.gc = NULL;
+}
+
+static void get_drag_pointer(NeuroPoint *p, const NeuroClientDragArg *da) {
+  assert(p);
+  if (da && da->pointer)
+    *p = *da->pointer;
+  else
+    NeuroSystemGetPointerWindowLocation(p, NULL);
+}
+
+// The pointer events are handled by the main loop until the button is released, see NeuroClientDragMotion
+static void start_drag(NeuroClientPtrPtr c, bool is_float, bool is_outline, const NeuroPoint *p,
+    XMotionUpdaterFn xmuf, Cursor cursor) {
+  assert(c);
+  assert(p);
+  if (drag_.win != None)
+    return;
+  if (GrabSuccess != XGrabPointer(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), false,
+      ButtonPressMask|ButtonReleaseMask|PointerMotionMask, GrabModeAsync, GrabModeAsync, None, cursor, CurrentTime))
+    return;
+
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  const NeuroMonitor *const m = NeuroCoreStackGetMonitor(client->ws);
+  drag_.win = client->win;
+  drag_.is_float = is_float;
+  memmove(&drag_.start_region, is_float ? NeuroCoreClientGetFloatRegion(c) : NeuroCoreClientGetRegion(c),
+      sizeof(NeuroRectangle));
+  drag_.start_pointer = *p;
+  drag_.xmuf = xmuf;
+  drag_.interval = 1000UL / (Time)(m && m->refresh_rate > 0 ? m->refresh_rate : NEURO_MONITOR_DEFAULT_REFRESH_RATE);
+  drag_.last_time = 0UL;
+  drag_.is_pending = false;
+  drag_.is_outline = is_outline && start_outline();
+  drag_.is_sync_waiting = false;
+#ifdef XSYNC
+  // Only resizes make the client redraw, and the outline does not configure it until the button is released
+  if (!drag_.is_outline && xmuf == xmotion_resize && client->info->sync_counter != None && !start_sync(client))
+    drag_.sync_alarm = None;
+#endif
+}
+
+static bool is_outline_resize(const NeuroClientPtrPtr c) {
+  assert(c);
+  return NeuroCoreStackGetCurrLayout(NEURO_CLIENT_PTR(c)->ws)->mod & NEURO_LAYOUT_MOD_OUTLINE;
+}
+
+// Only the dragged client is updated, free clients are not arranged by the layout
+// With a sync alarm, the client is not resized again until it has redrawn (or the timeout expired)
+static void update_drag(NeuroClientPtrPtr c, Time time) {
+  assert(c);
+#ifdef XSYNC
+  if (drag_.sync_alarm != None) {
+    if (drag_.is_sync_waiting && time - drag_.sync_time < DRAG_SYNC_TIMEOUT)
+      return;
+    send_sync_request(NEURO_CLIENT_PTR(c)->win, time);
+  }
+#else
+  (void)time;
+#endif
+  if (NEURO_CLIENT_PTR(c)->free_setter_fn == NeuroRuleFreeSetterNull)
+    NeuroLayoutRunCurr(NEURO_CLIENT_PTR(c)->ws);
+  NeuroClientUpdate(c, NULL);
+  drag_.is_pending = false;
+}
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PUBLIC FUNCTION DEFINITION
@@ -115,8 +386,14 @@ void NeuroClientUpdate(NeuroClientPtrPtr c, const void *data) {
   if (!c)
     return;
 
-  // Get workspace and regions
+  // Clients of stacks without monitor are only unmapped, they are configured once the stack is shown again
   NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  if (!NeuroCoreStackGetMonitor(client->ws)) {
+    apply_mapped(client, false);
+    return;
+  }
+
+  // Get workspace and regions
   const NeuroRectangle *const stack_region = NeuroCoreStackGetRegion(client->ws);
   NeuroRectangle *const client_region = NeuroCoreClientGetRegion(c);
 
@@ -126,6 +403,7 @@ void NeuroClientUpdate(NeuroClientPtrPtr c, const void *data) {
     NeuroGeometryRectangleGetIncreased(&r, stack_region, NeuroCoreStackGetGaps(client->ws));
   } else if (client->free_setter_fn != NeuroRuleFreeSetterNull) {
     client->free_setter_fn(client_region, stack_region);
+    NeuroCoreStackInvalidateRegions(client->ws);
     memmove(&r, client_region, sizeof(NeuroRectangle));
   } else if (client->fixed_pos != NEURO_FIXED_POSITION_NULL) {
     NeuroRuleSetClientRegion(&r, c);
@@ -138,15 +416,112 @@ void NeuroClientUpdate(NeuroClientPtrPtr c, const void *data) {
   const int border_width = l->border_width_setter_fn(c);
   const int border_gap = l->border_gap_setter_fn(c);
   NeuroGeometryRectangleSetBorderWidthAndGap(&r, border_width, border_gap);
+  if ((l->mod & NEURO_LAYOUT_MOD_SIZEHINTS) && !client->is_fullscreen)
+    NeuroGeometryRectangleSetSizeHints(&r, &client->info->size_hints);
   if (r.w < 1)
     r.w = 1;
   if (r.h < 1)
     r.h = 1;
 
-  // Draw
-  XSetWindowBorder(NeuroSystemGetDisplay(), client->win, l->border_color_setter_fn(c));
-  XSetWindowBorderWidth(NeuroSystemGetDisplay(), client->win, border_width);
-  XMoveResizeWindow(NeuroSystemGetDisplay(), client->win, r.p.x, r.p.y, r.w, r.h);
+  // Draw, only sending the requests that change the window
+  apply_border_color(client, l->border_color_setter_fn(c));
+  apply_border_width(client, border_width);
+  apply_region(client, &r);
+  apply_mapped(client, true);
+}
+
+// Must be called when the window was configured without NeuroClientUpdate, so that the next update resends everything
+void NeuroClientInvalidateApplied(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  NeuroClientApplied *const a = &NEURO_CLIENT_PTR(c)->applied;
+  a->is_region_valid = false;
+  a->is_border_width_valid = false;
+  a->is_border_color_valid = false;
+}
+
+// Must be called when the region must be sent again even if it did not change, e.g. to answer a configure request
+void NeuroClientInvalidateRegion(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->applied.is_region_valid = false;
+}
+
+void NeuroClientGrabButtons(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  apply_buttons_grab(NEURO_CLIENT_PTR(c), true);
+}
+
+void NeuroClientUngrabButtons(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  apply_buttons_grab(NEURO_CLIENT_PTR(c), false);
+}
+
+// Must be called when the button grabs of the window are no longer valid, e.g. when the modifier mapping changes
+void NeuroClientInvalidateButtons(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->applied.is_buttons_grab_valid = false;
+}
+
+// Must be called when the window was mapped or unmapped without NeuroClientUpdate, e.g. before its first update
+void NeuroClientSetMapped(NeuroClientPtrPtr c, const void *is_mapped) {
+  if (!c || !is_mapped)
+    return;
+  NeuroClientApplied *const a = &NEURO_CLIENT_PTR(c)->applied;
+  a->is_mapped = *(const bool *)is_mapped;
+  a->is_map_valid = true;
+}
+
+// Consumes one of the UnmapNotify events caused by neurowm, returns false if the client unmapped the window itself
+bool NeuroClientIsUnmapIgnored(NeuroClientPtrPtr c) {
+  if (!c || NEURO_CLIENT_PTR(c)->info->ignore_unmaps == 0U)
+    return false;
+  --NEURO_CLIENT_PTR(c)->info->ignore_unmaps;
+  return true;
+}
+
+// Answers a configure request with the current geometry instead of the requested one (ICCCM 4.1.5)
+void NeuroClientDenyConfigureRequest(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  const NeuroClientApplied *const a = &client->applied;
+  if (!a->is_region_valid || !a->is_border_width_valid)
+    NeuroClientUpdate(c, NULL);
+  if (!a->is_region_valid || !a->is_border_width_valid)  // Hidden before being configured, it gets notified when shown
+    return;
+  XEvent e;
+  XConfigureEvent *const ce = &e.xconfigure;
+  ce->type = ConfigureNotify;
+  ce->display = NeuroSystemGetDisplay();
+  ce->event = client->win;
+  ce->window = client->win;
+  ce->x = a->region.p.x;
+  ce->y = a->region.p.y;
+  ce->width = a->region.w;
+  ce->height = a->region.h;
+  ce->border_width = a->border_width;
+  ce->above = None;
+  ce->override_redirect = false;
+  XSendEvent(NeuroSystemGetDisplay(), client->win, false, StructureNotifyMask, &e);
+  ++client->info->denied_configure_requests;
+}
+
+NeuroIndex NeuroClientGetDeniedConfigureRequests(const NeuroClientPtrPtr c) {
+  return c ? NEURO_CLIENT_PTR(c)->info->denied_configure_requests : 0U;
+}
+
+NeuroIndex NeuroClientGetSuppressedRequests(void) {
+  return suppressed_requests_;
 }
 
 void NeuroClientUpdateClassAndName(NeuroClientPtrPtr c, const void *data) {
@@ -159,15 +534,9 @@ void NeuroClientUpdateClassAndName(NeuroClientPtrPtr c, const void *data) {
   if (!XGetClassHint(NeuroSystemGetDisplay(), client->win, &ch))
     return;
 
-  // Reset class and name
-  assert(client->class);
-  client->class[ 0 ] = '\0';
-  assert(client->name);
-  client->name[ 0 ] = '\0';
-
-  // Set new class and name
-  strncpy(client->class, ch.res_class, NEURO_NAME_SIZE_MAX);
-  strncpy(client->name, ch.res_name, NEURO_NAME_SIZE_MAX);
+  // Set new class and name, interned so that rules can match them by pointer
+  client->info->class = NeuroTypeInternString(ch.res_class);
+  client->info->name = NeuroTypeInternString(ch.res_name);
 
   // Clean up
   if (ch.res_class)
@@ -183,26 +552,81 @@ void NeuroClientUpdateTitle(NeuroClientPtrPtr c, const void *data) {
 
   // Reset title
   NeuroClient *const client = NEURO_CLIENT_PTR(c);
-  assert(client->title);
-  client->title[ 0 ] = '\0';
+  NeuroTypeSetClientTitle(client, "");
 
   // Set new title
   if (!set_title_atom(client, NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_NAME)))
     set_title_atom(client, XA_WM_NAME);
 }
 
+void NeuroClientUpdateSizeHints(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  XSizeHints sh;
+  long supplied = 0L;
+  if (!XGetWMNormalHints(NeuroSystemGetDisplay(), client->win, &sh, &supplied))
+    sh.flags = 0L;
+  NeuroTypeSetClientSizeHints(client, &sh);
+}
+
+// The cache is only read back when someone else changes _NET_WM_STATE, neurowm writes it without reading it
+void NeuroClientUpdateNetStates(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  Atom states[ NEURO_NET_STATES_MAX ];
+  const NeuroIndex n = NeuroSystemGetWindowNetStates(client->win, states, NEURO_NET_STATES_MAX);
+  NeuroTypeSetClientNetStates(client, states, n);
+}
+
+// Whether the PropertyNotify of _NET_WM_STATE with that serial was caused by neurowm or superseded by its last change
+bool NeuroClientIsNetStateNotifyIgnored(NeuroClientPtrPtr c, unsigned long serial) {
+  if (!c || !NEURO_CLIENT_PTR(c)->applied.is_net_state_valid)
+    return false;
+  return (long)(serial - NEURO_CLIENT_PTR(c)->info->net_state_serial) <= 0L;
+}
+
+// The counter is only used if the client lists _NET_WM_SYNC_REQUEST in WM_PROTOCOLS and the server supports XSync
+void NeuroClientUpdateSyncCounter(NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  if (!c)
+    return;
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  client->info->sync_counter = None;
+#ifdef XSYNC
+  if (NeuroSystemGetSyncEventBase() < 0 ||
+      !has_protocol(client->win, NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_SYNCREQUEST)))
+    return;
+  Atom type = None;
+  int format = 0;
+  unsigned long n = 0UL, after = 0UL;
+  unsigned char *prop = NULL;
+  if (Success != XGetWindowProperty(NeuroSystemGetDisplay(), client->win,
+      NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_SYNCREQUESTCOUNTER), 0L, 1L, false, XA_CARDINAL, &type, &format, &n,
+      &after, &prop))
+    return;
+  if (prop && type == XA_CARDINAL && format == 32 && n == 1UL)
+    client->info->sync_counter = (XID)*(unsigned long *)(void *)prop;
+  if (prop)
+    XFree(prop);
+#endif
+}
+
 void NeuroClientSetUrgent(NeuroClientPtrPtr c, const void *data) {
   (void)data;
   if (!c)
     return;
-  NEURO_CLIENT_PTR(c)->is_urgent = true;
+  NeuroCoreClientSetUrgent(c, true);
 }
 
 void NeuroClientUnsetUrgent(NeuroClientPtrPtr c, const void *data) {
   (void)data;
   if (!c)
     return;
-  NEURO_CLIENT_PTR(c)->is_urgent = false;
+  NeuroCoreClientSetUrgent(c, false);
 }
 
 void NeuroClientKill(NeuroClientPtrPtr c, const void *data) {
@@ -210,7 +634,7 @@ void NeuroClientKill(NeuroClientPtrPtr c, const void *data) {
   if (!c)
     return;
   const Window win = NEURO_CLIENT_PTR(c)->win;
-  if (is_protocol_delete(win)) {
+  if (has_protocol(win, NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_DELETEWINDOW))) {
     XEvent ke;
     ke.type = ClientMessage;
     ke.xclient.window = win;
@@ -238,6 +662,7 @@ void NeuroClientMinimize(NeuroClientPtrPtr c, const void *data) {
   // Move client off screen
   XMoveWindow(NeuroSystemGetDisplay(), cli->win, NeuroSystemGetScreenRegion()->w + 1,
       NeuroSystemGetScreenRegion()->h + 1);
+  cli->applied.is_region_valid = false;
   NeuroLayoutRunCurr(cli->ws);
   NeuroWorkspaceFocus(cli->ws);
 }
@@ -252,7 +677,7 @@ void NeuroClientTile(NeuroClientPtrPtr c, const void *data) {
     return;
 
   // Tile the client
-  client->free_setter_fn = NeuroRuleFreeSetterNull;
+  NeuroCoreClientSetFreeSetter(c, NeuroRuleFreeSetterNull);
   NeuroLayoutRunCurr(client->ws);
   NeuroWorkspaceFocus(client->ws);
 }
@@ -267,7 +692,7 @@ void NeuroClientFree(NeuroClientPtrPtr c, const void *freeSetterFn) {
     return;
 
   // Free the client
-  client->free_setter_fn = gaf->FreeSetterFn_;
+  NeuroCoreClientSetFreeSetter(c, gaf->FreeSetterFn_);
   NeuroLayoutRunCurr(client->ws);
   NeuroWorkspaceFocus(client->ws);
 }
@@ -293,7 +718,8 @@ void NeuroClientNormal(NeuroClientPtrPtr c, const void *data) {
     return;
 
   // Normal the client
-  client->is_fullscreen = false;
+  NeuroCoreClientSetFullscreen(c, false);
+  apply_net_wm_state(client, client->is_fullscreen, !client->applied.is_mapped);
   NeuroLayoutRunCurr(client->ws);
   NeuroWorkspaceFocus(client->ws);
 }
@@ -308,7 +734,8 @@ void NeuroClientFullscreen(NeuroClientPtrPtr c, const void *data) {
     return;
 
   // Fullscreen the client
-  client->is_fullscreen = true;
+  NeuroCoreClientSetFullscreen(c, true);
+  apply_net_wm_state(client, client->is_fullscreen, !client->applied.is_mapped);
   NeuroLayoutRunCurr(client->ws);
   NeuroWorkspaceFocus(client->ws);
 }
@@ -325,8 +752,8 @@ void NeuroClientToggleFullscreen(NeuroClientPtrPtr c, const void *data) {
     NeuroClientFullscreen(c, NULL);
 }
 
-void NeuroClientFloatMove(NeuroClientPtrPtr c, const void *data) {
-  (void)data;
+// The drag argument may be NULL, then the pointer location is asked to the X server
+void NeuroClientFloatMove(NeuroClientPtrPtr c, const void *drag_arg) {
   if (!c)
     return;
 
@@ -339,15 +766,12 @@ void NeuroClientFloatMove(NeuroClientPtrPtr c, const void *data) {
     return;
 
   // Float move the client
-  NeuroRectangle *const r = &client->float_region, cr;
-  memmove(&cr, r, sizeof(NeuroRectangle));
   NeuroPoint p;
-  NeuroSystemGetPointerWindowLocation(&p, NULL);
-  process_xmotion(r, client->ws, &cr, &p, xmotion_move, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
+  get_drag_pointer(&p, (const NeuroClientDragArg *)drag_arg);
+  start_drag(c, true, false, &p, xmotion_move, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
 }
 
-void NeuroClientFloatResize(NeuroClientPtrPtr c, const void *data) {
-  (void)data;
+void NeuroClientFloatResize(NeuroClientPtrPtr c, const void *drag_arg) {
   if (!c)
     return;
 
@@ -360,64 +784,118 @@ void NeuroClientFloatResize(NeuroClientPtrPtr c, const void *data) {
     return;
 
   // Float resize the client
-  NeuroRectangle *const r = &client->float_region, cr;
-  memmove(&cr, r, sizeof(NeuroRectangle));
   NeuroPoint p;
-  NeuroSystemGetPointerWindowLocation(&p, NULL);
-  process_xmotion(r, client->ws, &cr, &p, xmotion_resize, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
+  get_drag_pointer(&p, (const NeuroClientDragArg *)drag_arg);
+  start_drag(c, true, is_outline_resize(c), &p, xmotion_resize, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
 }
 
-void NeuroClientFreeMove(NeuroClientPtrPtr c, const void *free_setter_fn) {
-  if (!c || !free_setter_fn)
+// The drag argument must be a NeuroClientDragArg with a free setter, the pointer may be NULL as in NeuroClientFloatMove
+void NeuroClientFreeDragMove(NeuroClientPtrPtr c, const void *drag_arg) {
+  const NeuroClientDragArg *const da = (const NeuroClientDragArg *)drag_arg;
+  if (!c || !da || !da->free_setter_fn)
     return;
 
   // Focus client and set it to free mode
   NeuroWorkspaceClientFocus(c, NeuroClientSelectorSelf, NULL);
-  NeuroClientFree(c, free_setter_fn);
+  NeuroClientFree(c, da->free_setter_fn);
 
   // Free move the client
-  NeuroRectangle *const r = NeuroCoreClientGetRegion(c), cr;
-  memmove(&cr, r, sizeof(NeuroRectangle));
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
   NeuroPoint p;
-  NeuroSystemGetPointerWindowLocation(&p, NULL);
-  process_xmotion(r, client->ws, &cr, &p, xmotion_move, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
+  get_drag_pointer(&p, da);
+  start_drag(c, false, false, &p, xmotion_move, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
 }
 
-void NeuroClientFreeResize(NeuroClientPtrPtr c, const void *free_setter_fn) {
-  if (!c || !free_setter_fn)
+void NeuroClientFreeDragResize(NeuroClientPtrPtr c, const void *drag_arg) {
+  const NeuroClientDragArg *const da = (const NeuroClientDragArg *)drag_arg;
+  if (!c || !da || !da->free_setter_fn)
     return;
 
   // Focus client and set it to free mode
   NeuroWorkspaceClientFocus(c, NeuroClientSelectorSelf, NULL);
-  NeuroClientFree(c, free_setter_fn);
+  NeuroClientFree(c, da->free_setter_fn);
 
   // Free resize the client
-  NeuroRectangle *const r = NeuroCoreClientGetRegion(c), cr;
-  memmove(&cr, r, sizeof(NeuroRectangle));
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
   NeuroPoint p;
-  NeuroSystemGetPointerWindowLocation(&p, NULL);
-  process_xmotion(r, client->ws, &cr, &p, xmotion_resize, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
+  get_drag_pointer(&p, da);
+  start_drag(c, false, is_outline_resize(c), &p, xmotion_resize, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
+}
+
+// Drag
+bool NeuroClientIsDragging(void) {
+  return drag_.win != None;
+}
+
+// Must be called for each pointer motion while dragging, x and y are root coordinates
+void NeuroClientDragMotion(int x, int y, Time time) {
+  if (drag_.win == None)
+    return;
+  NeuroClientPtrPtr c = NeuroClientFindWindow(drag_.win);
+  if (!c) {  // The client went away
+    NeuroClientStopDrag();
+    return;
+  }
+  NeuroRectangle *const r = drag_.is_outline ? &drag_.outline :
+      drag_.is_float ? NeuroCoreClientGetFloatRegion(c) : NeuroCoreClientGetRegion(c);
+  drag_.xmuf(r, &drag_.start_region, x, y, &drag_.start_pointer);
+  drag_.is_pending = true;
+  if (time - drag_.last_time < drag_.interval)
+    return;
+  drag_.last_time = time;
+  if (drag_.is_outline)
+    update_outline();
+  else
+    update_drag(c, time);
+}
+
+// Applies the last motion skipped by the refresh rate limit (or the outline) and ungrabs the pointer
+void NeuroClientStopDrag(void) {
+  if (drag_.win == None)
+    return;
+  XUngrabPointer(NeuroSystemGetDisplay(), CurrentTime);
+  if (drag_.is_outline)
+    stop_outline();
+  NeuroClientPtrPtr c = NeuroClientFindWindow(drag_.win);
+  if (c && drag_.is_pending) {
+    if (drag_.is_outline)  // The client is configured only once, with the last outline
+      memmove(drag_.is_float ? NeuroCoreClientGetFloatRegion(c) : NeuroCoreClientGetRegion(c), &drag_.outline,
+          sizeof(NeuroRectangle));
+    drag_.is_sync_waiting = false;  // The final region is always applied
+    update_drag(c, drag_.last_time);
+  }
+#ifdef XSYNC
+  if (drag_.sync_alarm != None)
+    stop_sync();
+#endif
+  drag_.win = None;
+}
+
+// Must be called when an alarm notifies that the client answered the last sync request
+void NeuroClientDragSyncNotify(XID alarm, Time time) {
+  if (drag_.win == None || drag_.sync_alarm == None || drag_.sync_alarm != alarm)
+    return;
+  drag_.is_sync_waiting = false;
+  NeuroClientPtrPtr c = NeuroClientFindWindow(drag_.win);
+  if (c && drag_.is_pending && !drag_.is_outline)
+    update_drag(c, time);
 }
 
 // Find
 NeuroClientPtrPtr NeuroClientFindWindow(Window w) {
-  return NeuroCoreFindClient(NeuroClientTesterWindow, (const void *)&w);
+  return NeuroCoreFindWindowClient(w);
 }
 
 NeuroClientPtrPtr NeuroClientFindUrgent(void) {
-  return NeuroCoreFindClient(NeuroClientTesterUrgent, NULL);
+  return NeuroCoreFindFlagClient(NEURO_CLIENT_FLAG_URGENT);
 }
 
 NeuroClientPtrPtr NeuroClientFindFixed(void) {
-  return NeuroCoreFindClient(NeuroClientTesterFixed, NULL);
+  return NeuroCoreFindFlagClient(NEURO_CLIENT_FLAG_FIXED);
 }
 
-// Note: This might return a lower window in the stacking order, use NeuroClientGetPointedByPointer() to always get
-// the upper window in the stacking order
+// Note: It returns the upper window in the stacking order set by the workspaces, use NeuroClientGetPointedByPointer()
+// to ask the X server instead
 NeuroClientPtrPtr NeuroClientFindPointed(const NeuroPoint *p) {
-  return NeuroCoreFindClient(NeuroClientTesterPointed, (const void *)p);
+  return NeuroCoreFindPointedClient(p);
 }
 
 NeuroClientPtrPtr NeuroClientFindHidden(void) {
@@ -454,9 +932,10 @@ bool NeuroClientTesterPointed(const NeuroClientPtrPtr c, const void *p) {
   return c && p && NeuroGeometryIsPointInRectangle(NeuroCoreClientGetRegion(c), (const NeuroPoint *)p);
 }
 
+// Clients of hidden workspaces are unmapped instead of being moved off screen
 bool NeuroClientTesterHidden(const NeuroClientPtrPtr c, const void *data) {
   (void)data;
-  return c && NeuroGeometryIsPointInRectangle(NeuroSystemGetHiddenRegion(), &NeuroCoreClientGetRegion(c)->p);
+  return c && !NEURO_CLIENT_PTR(c)->applied.is_mapped;
 }
 
 bool NeuroClientTesterFullscreen(const NeuroClientPtrPtr c, const void *data) {
@@ -518,42 +997,28 @@ NeuroClientPtrPtr NeuroClientSelectorUpper(const NeuroClientPtrPtr c) {
   if (!c)
     return NULL;
 
-  const NeuroRectangle *const r = NeuroCoreClientGetRegion(c);
-  NeuroPoint p;
-  NeuroGeometryPointGetUpper(&p, &r->p, 1);
-  ++p.x;  // Needed to avoid border issues
-  return NeuroWorkspaceClientFindPointed(NEURO_CLIENT_PTR(c)->ws, &p);
+  return NeuroCoreStackFindNearestClient(NEURO_CLIENT_PTR(c)->ws, c, NEURO_DIRECTION_UP);
 }
 
 NeuroClientPtrPtr NeuroClientSelectorLower(const NeuroClientPtrPtr c) {
   if (!c)
     return NULL;
 
-  const NeuroRectangle *const r = NeuroCoreClientGetRegion(c);
-  NeuroPoint p;
-  NeuroGeometryPointGetLower(&p, &r->p, r->h + 1);
-  ++p.x;  // Needed to avoid border issues
-  return NeuroWorkspaceClientFindPointed(NEURO_CLIENT_PTR(c)->ws, &p);
+  return NeuroCoreStackFindNearestClient(NEURO_CLIENT_PTR(c)->ws, c, NEURO_DIRECTION_DOWN);
 }
 
 NeuroClientPtrPtr NeuroClientSelectorLeft(const NeuroClientPtrPtr c) {
   if (!c)
     return NULL;
 
-  const NeuroRectangle *const r = NeuroCoreClientGetRegion(c);
-  NeuroPoint p;
-  NeuroGeometryPointGetLeft(&p, &r->p, 1);
-  ++p.y;  // Needed to avoid border issues
-  return NeuroWorkspaceClientFindPointed(NEURO_CLIENT_PTR(c)->ws, &p);
+  return NeuroCoreStackFindNearestClient(NEURO_CLIENT_PTR(c)->ws, c, NEURO_DIRECTION_LEFT);
 }
 
 NeuroClientPtrPtr NeuroClientSelectorRight(const NeuroClientPtrPtr c) {
-  assert(c);
-  const NeuroRectangle *const r = NeuroCoreClientGetRegion(c);
-  NeuroPoint p;
-  NeuroGeometryPointGetRight(&p, &r->p, r->w + 1);
-  ++p.y;  // Needed to avoid border issues
-  return NeuroWorkspaceClientFindPointed(NEURO_CLIENT_PTR(c)->ws, &p);
+  if (!c)
+    return NULL;
+
+  return NeuroCoreStackFindNearestClient(NEURO_CLIENT_PTR(c)->ws, c, NEURO_DIRECTION_RIGHT);
 }
 
 // Color Setters
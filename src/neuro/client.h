@@ -23,8 +23,22 @@
 
 // Basic Functions
 void NeuroClientUpdate(NeuroClientPtrPtr c, const void *data);
+void NeuroClientInvalidateApplied(NeuroClientPtrPtr c, const void *data);
+void NeuroClientInvalidateRegion(NeuroClientPtrPtr c, const void *data);
+void NeuroClientGrabButtons(NeuroClientPtrPtr c, const void *data);
+void NeuroClientUngrabButtons(NeuroClientPtrPtr c, const void *data);
+void NeuroClientInvalidateButtons(NeuroClientPtrPtr c, const void *data);
+void NeuroClientSetMapped(NeuroClientPtrPtr c, const void *is_mapped);
+bool NeuroClientIsUnmapIgnored(NeuroClientPtrPtr c);
+void NeuroClientDenyConfigureRequest(NeuroClientPtrPtr c, const void *data);
+NeuroIndex NeuroClientGetDeniedConfigureRequests(const NeuroClientPtrPtr c);
+NeuroIndex NeuroClientGetSuppressedRequests(void);
 void NeuroClientUpdateClassAndName(NeuroClientPtrPtr c, const void *data);
 void NeuroClientUpdateTitle(NeuroClientPtrPtr c, const void *data);
+void NeuroClientUpdateSizeHints(NeuroClientPtrPtr c, const void *data);
+void NeuroClientUpdateSyncCounter(NeuroClientPtrPtr c, const void *data);
+void NeuroClientUpdateNetStates(NeuroClientPtrPtr c, const void *data);
+bool NeuroClientIsNetStateNotifyIgnored(NeuroClientPtrPtr c, unsigned long serial);
 void NeuroClientSetUrgent(NeuroClientPtrPtr c, const void *data);
 void NeuroClientUnsetUrgent(NeuroClientPtrPtr c, const void *data);
 void NeuroClientKill(NeuroClientPtrPtr c, const void *data);
@@ -35,10 +49,16 @@ void NeuroClientToggleFree(NeuroClientPtrPtr c, const void *free_setter_fn);
 void NeuroClientNormal(NeuroClientPtrPtr c, const void *data);
 void NeuroClientFullscreen(NeuroClientPtrPtr c, const void *data);
 void NeuroClientToggleFullscreen(NeuroClientPtrPtr c, const void *data);
-void NeuroClientFloatMove(NeuroClientPtrPtr c, const void *data);
-void NeuroClientFloatResize(NeuroClientPtrPtr c, const void *data);
-void NeuroClientFreeMove(NeuroClientPtrPtr c, const void *free_setter_fn);
-void NeuroClientFreeResize(NeuroClientPtrPtr c, const void *free_setter_fn);
+void NeuroClientFloatMove(NeuroClientPtrPtr c, const void *drag_arg);
+void NeuroClientFloatResize(NeuroClientPtrPtr c, const void *drag_arg);
+void NeuroClientFreeDragMove(NeuroClientPtrPtr c, const void *drag_arg);
+void NeuroClientFreeDragResize(NeuroClientPtrPtr c, const void *drag_arg);
+
+// Drag
+bool NeuroClientIsDragging(void);
+void NeuroClientDragMotion(int x, int y, Time time);
+void NeuroClientStopDrag(void);
+void NeuroClientDragSyncNotify(XID alarm, Time time);
 
 // Find Client
 NeuroClientPtrPtr NeuroClientFindWindow(Window w);
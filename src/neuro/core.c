@@ -17,9 +17,14 @@
 #include "config.h"
 #include "geometry.h"
 #include "monitor.h"
+#include "rule.h"
 
 // Defines
 #define STEP_SIZE_REALLOC 32
+#define WINDOW_INDEX_MIN_SIZE 64  // Must be a power of 2
+#define NODE_POOL_CHUNK_ITEMS 64
+#define SPATIAL_INDEX_MAX_CELLS 16  // Maximum number of cells per axis
+#define NODE_NO_HANDLE ((NeuroIndex)-1)  // Handle of the nodes that are not in a stack, i.e. minimized ones
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -32,7 +37,28 @@ struct Node {
   NeuroClient *cli;
   Node *next;
   Node *prev;
-  NeuroRectangle region;
+  NeuroIndex handle;  // Index of the region and float region of the node in the arrays of its stack
+  unsigned int flags;  // Flag lists the node is linked in, as a bit mask of NeuroClientFlag
+  Node *flag_next[ NEURO_CLIENT_FLAG_END ];
+  Node *flag_prev[ NEURO_CLIENT_FLAG_END ];
+  Node *z_above;  // Stacking order of the windows of the stack
+  Node *z_below;
+  NeuroIndex z_rank;  // Higher than the ranks of the nodes below it in the stacking order
+};
+
+// SpatialIndex (uniform grid over the regions of the nodes of a stack, rebuilt lazily when it is dirty)
+typedef struct SpatialIndex SpatialIndex;
+struct SpatialIndex {
+  bool is_dirty;
+  NeuroRectangle bounds;  // Bounding box of all the regions
+  int cols;
+  int rows;
+  int cell_w;
+  int cell_h;
+  NeuroIndex *cell_starts;  // Offset of each cell in cell_nodes, plus the total number of entries at the end
+  Node **cell_nodes;  // Nodes overlapping each cell, in stack order
+  NeuroIndex cell_starts_size;  // Allocated size
+  NeuroIndex cell_nodes_size;  // Allocated size
 };
 
 // Stack
@@ -56,8 +82,45 @@ struct Stack {
   NeuroLayout *layouts;
   NeuroLayout *toggled_layouts;
   NeuroIndex num_minimized;  // Number of minimized clients
-  NeuroClient **minimized_clients;  // List of minimized clients
-  NeuroIndex minimized_size;  // Allocated size
+  Node *minimized_head;  // List of minimized clients, in the order they were minimized
+  Node *minimized_last;
+  Node *flag_heads[ NEURO_CLIENT_FLAG_END ];  // List of nodes whose client has each flag
+  NeuroIndex flag_counts[ NEURO_CLIENT_FLAG_END ];  // Number of nodes in each flag list
+  SpatialIndex spatial_index;
+  NeuroRectangle *regions;  // Region of each node, indexed by its handle, handles are 0 to size-1
+  NeuroRectangle *float_regions;  // Float region of each node, indexed by its handle
+  Node **handle_nodes;  // Node of each handle
+  NeuroIndex handles_size;  // Allocated size
+  NeuroArrange arrange;  // Reused by every layout run, views the regions of the tiled nodes
+  Node *z_top;  // Topmost window of the stack, as it was last restacked
+  NeuroIndex z_last_rank;  // Rank of the last node pushed on top
+  bool is_z_dirty;  // Whether the stacking order of the X server might differ from the one of the stack
+  const NeuroMonitor *arranged_monitor;  // Monitor whose region the clients were last arranged for, NULL if none
+};
+
+// WindowEntry
+typedef struct WindowEntry WindowEntry;
+struct WindowEntry {
+  Window win;  // None if the entry is empty
+  Node *node;  // Node of the client, either in the stack or in the minimized list
+  bool is_minimized;
+};
+
+// WindowIndex (open addressing hash table with linear probing, keyed by window)
+typedef struct WindowIndex WindowIndex;
+struct WindowIndex {
+  WindowEntry *entries;
+  NeuroIndex size;  // Allocated size, always a power of 2
+  NeuroIndex count;  // Number of used entries
+};
+
+// NodeMatch (best candidate of a spatial query)
+typedef struct NodeMatch NodeMatch;
+struct NodeMatch {
+  Node *node;
+  int distance;
+  int edge_distance;
+  NeuroIndex rank;
 };
 
 // StackSet
@@ -67,6 +130,8 @@ struct StackSet {
   NeuroIndex curr;
   NeuroIndex old;  // Previouse selected workspace
   NeuroIndex size;  // Number of stacks the stackset has
+  WindowIndex window_index;  // Index of all the managed clients (tiled and minimized)
+  NeuroPool node_pool;  // Storage of the nodes of all the stacks
 };
 
 
@@ -82,6 +147,96 @@ static StackSet stack_set_;
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+static NeuroIndex hash_window(Window w, NeuroIndex size) {
+  uint64_t h = (uint64_t)w;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return (NeuroIndex)h & (size - 1U);
+}
+
+static WindowEntry *find_window_entry(const WindowIndex *wi, Window w) {
+  if (w == None || !wi->entries)
+    return NULL;
+  for (NeuroIndex i = hash_window(w, wi->size); wi->entries[ i ].win != None; i = (i + 1U) & (wi->size - 1U))
+    if (wi->entries[ i ].win == w)
+      return wi->entries + i;
+  return NULL;
+}
+
+static bool resize_window_index(WindowIndex *wi, NeuroIndex new_size) {
+  assert(wi);
+  WindowEntry *const old_entries = wi->entries;
+  const NeuroIndex old_size = wi->size;
+  WindowEntry *const new_entries = (WindowEntry *)calloc(new_size, sizeof(WindowEntry));
+  if (!new_entries)
+    return false;
+
+  // Rehash the old entries into the new table
+  for (NeuroIndex i = 0U; i < old_size; ++i) {
+    const WindowEntry *const e = old_entries + i;
+    if (e->win == None)
+      continue;
+    NeuroIndex j = hash_window(e->win, new_size);
+    while (new_entries[ j ].win != None)
+      j = (j + 1U) & (new_size - 1U);
+    memmove(new_entries + j, e, sizeof(WindowEntry));
+  }
+
+  free(old_entries);
+  wi->entries = new_entries;
+  wi->size = new_size;
+  return true;
+}
+
+static bool insert_window_entry(WindowIndex *wi, Window w, Node *n, bool is_minimized) {
+  assert(wi);
+  if (w == None)
+    return true;
+
+  // Update the entry if the window is already indexed
+  WindowEntry *e = find_window_entry(wi, w);
+  if (e) {
+    e->node = n;
+    e->is_minimized = is_minimized;
+    return true;
+  }
+
+  // Keep the load factor under 1/2
+  if ((wi->count + 1U) * 2U > wi->size && !resize_window_index(wi, wi->size * 2U))
+    return false;
+
+  NeuroIndex i = hash_window(w, wi->size);
+  while (wi->entries[ i ].win != None)
+    i = (i + 1U) & (wi->size - 1U);
+  e = wi->entries + i;
+  e->win = w;
+  e->node = n;
+  e->is_minimized = is_minimized;
+  wi->count++;
+  return true;
+}
+
+// Uses backward shift deletion, so that no tombstones are needed
+static void remove_window_entry(WindowIndex *wi, Window w) {
+  assert(wi);
+  WindowEntry *const e = find_window_entry(wi, w);
+  if (!e)
+    return;
+
+  const NeuroIndex mask = wi->size - 1U;
+  NeuroIndex hole = (NeuroIndex)(e - wi->entries);
+  for (NeuroIndex i = (hole + 1U) & mask; wi->entries[ i ].win != None; i = (i + 1U) & mask) {
+    const NeuroIndex home = hash_window(wi->entries[ i ].win, wi->size);
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      memmove(wi->entries + hole, wi->entries + i, sizeof(WindowEntry));
+      hole = i;
+    }
+  }
+  wi->entries[ hole ] = (WindowEntry){ None, NULL, false };
+  wi->count--;
+}
+
 static void update_nsp_stack(Stack *s) {
   assert(s);
   for (Node *n = s->head; n; n = n->next)
@@ -92,22 +247,452 @@ static void update_nsp_stack(Stack *s) {
   s->nsp = NULL;
 }
 
+static bool is_region_empty(const NeuroRectangle *r) {
+  assert(r);
+  return r->w < 0 || r->h < 0;
+}
+
+static int get_cell_col(const SpatialIndex *si, int x) {
+  const int col = (x - si->bounds.p.x) / si->cell_w;
+  return col < 0 ? 0 : col >= si->cols ? si->cols - 1 : col;
+}
+
+static int get_cell_row(const SpatialIndex *si, int y) {
+  const int row = (y - si->bounds.p.y) / si->cell_h;
+  return row < 0 ? 0 : row >= si->rows ? si->rows - 1 : row;
+}
+
+static bool reserve_spatial_index(SpatialIndex *si, NeuroIndex cells, NeuroIndex nodes) {
+  assert(si);
+  if (cells > si->cell_starts_size) {
+    NeuroIndex *const cs = (NeuroIndex *)realloc(si->cell_starts, cells*sizeof(NeuroIndex));
+    if (!cs)
+      return false;
+    si->cell_starts = cs;
+    si->cell_starts_size = cells;
+  }
+  if (nodes > si->cell_nodes_size) {
+    Node **const cn = (Node **)realloc(si->cell_nodes, nodes*sizeof(Node *));
+    if (!cn)
+      return false;
+    si->cell_nodes = cn;
+    si->cell_nodes_size = nodes;
+  }
+  return true;
+}
+
+static NeuroRectangle *get_node_region(const Stack *s, const Node *n) {
+  assert(s);
+  assert(n);
+  assert(n->handle < s->size);
+  return s->regions + n->handle;
+}
+
+// Counts the entries of each cell first and then fills them, so that each cell is a contiguous slice of cell_nodes
+static bool build_spatial_index(Stack *s) {
+  assert(s);
+  SpatialIndex *const si = &s->spatial_index;
+  si->cols = 0;
+  si->rows = 0;
+
+  // Get the bounding box
+  bool has_bounds = false;
+  int x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+  for (const Node *n = s->head; n; n = n->next) {
+    const NeuroRectangle *const r = get_node_region(s, n);
+    if (is_region_empty(r))
+      continue;
+    if (!has_bounds || r->p.x < x1)
+      x1 = r->p.x;
+    if (!has_bounds || r->p.y < y1)
+      y1 = r->p.y;
+    if (!has_bounds || r->p.x + r->w > x2)
+      x2 = r->p.x + r->w;
+    if (!has_bounds || r->p.y + r->h > y2)
+      y2 = r->p.y + r->h;
+    has_bounds = true;
+  }
+  si->is_dirty = false;
+  if (!has_bounds)
+    return true;
+
+  // Set the grid, with about one cell per client
+  int size = 1;
+  while (size < SPATIAL_INDEX_MAX_CELLS && (NeuroIndex)(size*size) < s->size)
+    ++size;
+  si->bounds.p.x = x1;
+  si->bounds.p.y = y1;
+  si->bounds.w = x2 - x1;
+  si->bounds.h = y2 - y1;
+  si->cols = size;
+  si->rows = size;
+  si->cell_w = (si->bounds.w + size) / size;  // Regions include their right and bottom edges
+  si->cell_h = (si->bounds.h + size) / size;
+  const NeuroIndex num_cells = (NeuroIndex)(size*size);
+  if (!reserve_spatial_index(si, num_cells + 1U, 0U))
+    return false;
+
+  // Count the entries of each cell
+  memset(si->cell_starts, 0, (num_cells + 1U)*sizeof(NeuroIndex));
+  for (const Node *n = s->head; n; n = n->next) {
+    const NeuroRectangle *const r = get_node_region(s, n);
+    if (is_region_empty(r))
+      continue;
+    const int c1 = get_cell_col(si, r->p.x), c2 = get_cell_col(si, r->p.x + r->w);
+    const int r1 = get_cell_row(si, r->p.y), r2 = get_cell_row(si, r->p.y + r->h);
+    for (int row = r1; row <= r2; ++row)
+      for (int col = c1; col <= c2; ++col)
+        si->cell_starts[ row*size + col + 1 ]++;
+  }
+  for (NeuroIndex i = 1U; i <= num_cells; ++i)
+    si->cell_starts[ i ] += si->cell_starts[ i - 1U ];
+  if (!reserve_spatial_index(si, 0U, si->cell_starts[ num_cells ]))
+    return false;
+
+  // Fill the cells, using the start of each cell as a cursor and shifting the starts back afterwards
+  for (Node *n = s->head; n; n = n->next) {
+    const NeuroRectangle *const r = get_node_region(s, n);
+    if (is_region_empty(r))
+      continue;
+    const int c1 = get_cell_col(si, r->p.x), c2 = get_cell_col(si, r->p.x + r->w);
+    const int r1 = get_cell_row(si, r->p.y), r2 = get_cell_row(si, r->p.y + r->h);
+    for (int row = r1; row <= r2; ++row)
+      for (int col = c1; col <= c2; ++col)
+        si->cell_nodes[ si->cell_starts[ row*size + col ]++ ] = n;
+  }
+  for (NeuroIndex i = num_cells; i > 0U; --i)
+    si->cell_starts[ i ] = si->cell_starts[ i - 1U ];
+  si->cell_starts[ 0 ] = 0U;
+  return true;
+}
+
+static bool update_spatial_index(Stack *s) {
+  assert(s);
+  if (!s->spatial_index.is_dirty)
+    return true;
+  if (build_spatial_index(s))
+    return true;
+  s->spatial_index.is_dirty = true;
+  s->spatial_index.cols = 0;
+  s->spatial_index.rows = 0;
+  return false;
+}
+
+static bool reserve_handles(Stack *s, NeuroIndex size) {
+  assert(s);
+  if (size <= s->handles_size)
+    return true;
+
+  // Get the new needed size
+  NeuroIndex new_size = STEP_SIZE_REALLOC;
+  while (new_size < size)
+    new_size += STEP_SIZE_REALLOC;
+
+  Node **const ns = (Node **)realloc(s->handle_nodes, new_size*sizeof(Node *));
+  if (!ns)
+    return false;
+  s->handle_nodes = ns;
+  NeuroRectangle *const rs = (NeuroRectangle *)realloc(s->regions, new_size*sizeof(NeuroRectangle));
+  if (!rs)
+    return false;
+  s->regions = rs;
+  NeuroRectangle *const frs = (NeuroRectangle *)realloc(s->float_regions, new_size*sizeof(NeuroRectangle));
+  if (!frs)
+    return false;
+  s->float_regions = frs;
+  s->handles_size = new_size;
+  return true;
+}
+
+static void swap_handles(Stack *s, NeuroIndex h1, NeuroIndex h2) {
+  assert(s);
+  const NeuroRectangle r = s->regions[ h1 ];
+  s->regions[ h1 ] = s->regions[ h2 ];
+  s->regions[ h2 ] = r;
+  const NeuroRectangle fr = s->float_regions[ h1 ];
+  s->float_regions[ h1 ] = s->float_regions[ h2 ];
+  s->float_regions[ h2 ] = fr;
+  Node *const n = s->handle_nodes[ h1 ];
+  s->handle_nodes[ h1 ] = s->handle_nodes[ h2 ];
+  s->handle_nodes[ h2 ] = n;
+  s->handle_nodes[ h1 ]->handle = h1;
+  s->handle_nodes[ h2 ]->handle = h2;
+}
+
+// The node starts at its float region, the handles must have been reserved for it
+static void link_node_handle(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  assert(s->size < s->handles_size);
+  const NeuroIndex h = s->size;
+  s->regions[ h ] = n->cli->float_region;
+  s->float_regions[ h ] = n->cli->float_region;
+  s->handle_nodes[ h ] = n;
+  n->handle = h;
+}
+
+// The last handle takes the place of the one of the node, and the float region goes back to the client
+static void unlink_node_handle(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  assert(s->size > 0U);
+  const NeuroIndex last = s->size - 1U;
+  n->cli->float_region = s->float_regions[ n->handle ];
+  if (n->handle != last)
+    swap_handles(s, n->handle, last);
+  n->handle = NODE_NO_HANDLE;
+}
+
+static void stop_spatial_index(SpatialIndex *si) {
+  assert(si);
+  free(si->cell_starts);
+  si->cell_starts = NULL;
+  free(si->cell_nodes);
+  si->cell_nodes = NULL;
+  si->cell_starts_size = 0U;
+  si->cell_nodes_size = 0U;
+  si->cols = 0;
+  si->rows = 0;
+}
+
+// Distance between the reference region and the region in direction d, negative if it is not in that direction
+static int get_direction_distance(const NeuroRectangle *ref, const NeuroRectangle *r, NeuroDirection d) {
+  assert(ref);
+  assert(r);
+  switch (d) {
+    case NEURO_DIRECTION_UP:
+      return r->p.x < ref->p.x + ref->w && ref->p.x < r->p.x + r->w ? ref->p.y - (r->p.y + r->h) : -1;
+    case NEURO_DIRECTION_DOWN:
+      return r->p.x < ref->p.x + ref->w && ref->p.x < r->p.x + r->w ? r->p.y - (ref->p.y + ref->h) : -1;
+    case NEURO_DIRECTION_LEFT:
+      return r->p.y < ref->p.y + ref->h && ref->p.y < r->p.y + r->h ? ref->p.x - (r->p.x + r->w) : -1;
+    case NEURO_DIRECTION_RIGHT:
+      return r->p.y < ref->p.y + ref->h && ref->p.y < r->p.y + r->h ? r->p.x - (ref->p.x + ref->w) : -1;
+    case NEURO_DIRECTION_END:
+    default:
+      return -1;
+  }
+}
+
+// Distance between the top left corner of the reference region and the region, along the edge facing direction d
+static int get_edge_distance(const NeuroRectangle *ref, const NeuroRectangle *r, NeuroDirection d) {
+  assert(ref);
+  assert(r);
+  const bool is_vertical = d == NEURO_DIRECTION_UP || d == NEURO_DIRECTION_DOWN;
+  const int p = is_vertical ? ref->p.x + 1 : ref->p.y + 1;
+  const int p1 = is_vertical ? r->p.x : r->p.y;
+  const int p2 = is_vertical ? r->p.x + r->w : r->p.y + r->h;
+  return p < p1 ? p1 - p : p > p2 ? p - p2 : 0;
+}
+
+static bool client_has_flag(const NeuroClient *c, NeuroClientFlag f) {
+  assert(c);
+  switch (f) {
+    case NEURO_CLIENT_FLAG_URGENT:
+      return c->is_urgent;
+    case NEURO_CLIENT_FLAG_FIXED:
+      return c->fixed_pos != NEURO_FIXED_POSITION_NULL;
+    case NEURO_CLIENT_FLAG_FULLSCREEN:
+      return c->is_fullscreen;
+    case NEURO_CLIENT_FLAG_FREE:
+      return c->free_setter_fn != NeuroRuleFreeSetterNull;
+    case NEURO_CLIENT_FLAG_END:
+    default:
+      return false;
+  }
+}
+
+static void match_pointed_node(NodeMatch *m, const Stack *s, Node *n, const NeuroPoint *p) {
+  assert(m);
+  assert(n);
+  if (!NeuroGeometryIsPointInRectangle(get_node_region(s, n), p))
+    return;
+  if (m->node && n->z_rank <= m->rank)
+    return;
+  m->node = n;
+  m->rank = n->z_rank;
+}
+
+static void match_nearest_node(NodeMatch *m, const Stack *s, const Node *ref, Node *n, NeuroDirection d) {
+  assert(m);
+  assert(ref);
+  assert(n);
+  const NeuroRectangle *const r = get_node_region(s, n);
+  if (n == ref || is_region_empty(r))
+    return;
+  const int distance = get_direction_distance(get_node_region(s, ref), r, d);
+  if (distance < 0)
+    return;
+  const int edge_distance = get_edge_distance(get_node_region(s, ref), r, d);
+  if (m->node && (distance > m->distance || (distance == m->distance && (edge_distance > m->edge_distance ||
+      (edge_distance == m->edge_distance && n->z_rank <= m->rank)))))
+    return;
+  m->node = n;
+  m->distance = distance;
+  m->edge_distance = edge_distance;
+  m->rank = n->z_rank;
+}
+
+static Node *find_pointed_node(Stack *s, const NeuroPoint *p) {
+  assert(s);
+  assert(p);
+  NodeMatch m = { NULL, 0, 0, 0 };
+
+  // Scan the whole stack if the index could not be built
+  if (!update_spatial_index(s)) {
+    for (Node *n = s->head; n; n = n->next)
+      match_pointed_node(&m, s, n, p);
+    return m.node;
+  }
+
+  // Only check the nodes of the cell that has the point
+  const SpatialIndex *const si = &s->spatial_index;
+  if (si->cols == 0 || !NeuroGeometryIsPointInRectangle(&si->bounds, p))
+    return NULL;
+  const NeuroIndex cell = (NeuroIndex)(get_cell_row(si, p->y)*si->cols + get_cell_col(si, p->x));
+  for (NeuroIndex i = si->cell_starts[ cell ]; i < si->cell_starts[ cell + 1U ]; ++i)
+    match_pointed_node(&m, s, si->cell_nodes[ i ], p);
+  return m.node;
+}
+
+// Lower bound of the distance to the nodes that are entirely beyond the given line of cells in direction d
+static int get_line_distance(const SpatialIndex *si, const NeuroRectangle *r, int line, NeuroDirection d) {
+  assert(si);
+  assert(r);
+  switch (d) {
+    case NEURO_DIRECTION_UP:
+      return r->p.y - (si->bounds.p.y + (line + 1)*si->cell_h - 1);
+    case NEURO_DIRECTION_DOWN:
+      return si->bounds.p.y + line*si->cell_h - (r->p.y + r->h);
+    case NEURO_DIRECTION_LEFT:
+      return r->p.x - (si->bounds.p.x + (line + 1)*si->cell_w - 1);
+    case NEURO_DIRECTION_RIGHT:
+      return si->bounds.p.x + line*si->cell_w - (r->p.x + r->w);
+    case NEURO_DIRECTION_END:
+    default:
+      return 0;
+  }
+}
+
+static Node *find_nearest_node(Stack *s, const Node *ref, NeuroDirection d) {
+  assert(s);
+  assert(ref);
+  NodeMatch m = { NULL, 0, 0, 0 };
+  if (d >= NEURO_DIRECTION_END || is_region_empty(get_node_region(s, ref)))
+    return NULL;
+
+  // Scan the whole stack if the index could not be built
+  if (!update_spatial_index(s)) {
+    for (Node *n = s->head; n; n = n->next)
+      match_nearest_node(&m, s, ref, n, d);
+    return m.node;
+  }
+  const SpatialIndex *const si = &s->spatial_index;
+  if (si->cols == 0)
+    return NULL;
+
+  // Get the cells along the edge of the reference region, and the line of cells that has that edge
+  const NeuroRectangle *const r = get_node_region(s, ref);
+  const bool is_vertical = d == NEURO_DIRECTION_UP || d == NEURO_DIRECTION_DOWN;
+  const int first = is_vertical ? get_cell_col(si, r->p.x) : get_cell_row(si, r->p.y);
+  const int last = is_vertical ? get_cell_col(si, r->p.x + r->w) : get_cell_row(si, r->p.y + r->h);
+  int line = 0, end = 0, step = 0;
+  if (d == NEURO_DIRECTION_UP) {
+    line = get_cell_row(si, r->p.y), end = -1, step = -1;
+  } else if (d == NEURO_DIRECTION_DOWN) {
+    line = get_cell_row(si, r->p.y + r->h), end = si->rows, step = 1;
+  } else if (d == NEURO_DIRECTION_LEFT) {
+    line = get_cell_col(si, r->p.x), end = -1, step = -1;
+  } else {
+    line = get_cell_col(si, r->p.x + r->w), end = si->cols, step = 1;
+  }
+
+  // Scan the lines of cells outwards until no closer node can be found
+  for ( ; line != end; line += step) {
+    if (m.node && m.distance < get_line_distance(si, r, line, d))
+      break;
+    for (int i = first; i <= last; ++i) {
+      const NeuroIndex cell = (NeuroIndex)(is_vertical ? line*si->cols + i : i*si->cols + line);
+      for (NeuroIndex j = si->cell_starts[ cell ]; j < si->cell_starts[ cell + 1U ]; ++j)
+        match_nearest_node(&m, s, ref, si->cell_nodes[ j ], d);
+    }
+  }
+  return m.node;
+}
+
+static void link_flag_node(Stack *s, Node *n, NeuroClientFlag f) {
+  assert(s);
+  assert(n);
+  n->flag_prev[ f ] = NULL;
+  n->flag_next[ f ] = s->flag_heads[ f ];
+  if (s->flag_heads[ f ])
+    s->flag_heads[ f ]->flag_prev[ f ] = n;
+  s->flag_heads[ f ] = n;
+  s->flag_counts[ f ]++;
+  n->flags |= 1U << f;
+}
+
+static void unlink_flag_node(Stack *s, Node *n, NeuroClientFlag f) {
+  assert(s);
+  assert(n);
+  if (n->flag_prev[ f ])
+    n->flag_prev[ f ]->flag_next[ f ] = n->flag_next[ f ];
+  else
+    s->flag_heads[ f ] = n->flag_next[ f ];
+  if (n->flag_next[ f ])
+    n->flag_next[ f ]->flag_prev[ f ] = n->flag_prev[ f ];
+  n->flag_next[ f ] = NULL;
+  n->flag_prev[ f ] = NULL;
+  s->flag_counts[ f ]--;
+  n->flags &= ~(1U << f);
+}
+
+// Links or unlinks the node in the flag lists of its stack, so that they match the client
+static void sync_node_flags(Node *n) {
+  assert(n);
+  Stack *const s = stack_set_.stack_list + n->cli->ws;
+  for (unsigned int i = 0U; i < NEURO_CLIENT_FLAG_END; ++i) {
+    const NeuroClientFlag f = (NeuroClientFlag)i;
+    const bool is_linked = (n->flags & (1U << f)) != 0U;
+    if (client_has_flag(n->cli, f) == is_linked)
+      continue;
+    if (is_linked)
+      unlink_flag_node(s, n, f);
+    else
+      link_flag_node(s, n, f);
+  }
+}
+
+static void unlink_node_flags(Node *n) {
+  assert(n);
+  Stack *const s = stack_set_.stack_list + n->cli->ws;
+  for (unsigned int i = 0U; i < NEURO_CLIENT_FLAG_END; ++i)
+    if (n->flags & (1U << i))
+      unlink_flag_node(s, n, (NeuroClientFlag)i);
+}
+
 static Node *new_node(NeuroClient *c) {
   assert(c);
-  Node *const n = (Node *)malloc(sizeof(Node));
+  Node *const n = (Node *)NeuroTypePoolAlloc(&stack_set_.node_pool);
   if (!n)
     return NULL;
   n->cli = (NeuroClient *)c;
-  memmove(&(n->region), &(c->float_region), sizeof(NeuroRectangle));
+  n->handle = NODE_NO_HANDLE;
   n->next = NULL;
   n->prev = NULL;
+  n->flags = 0U;
+  memset(n->flag_next, 0, sizeof(n->flag_next));
+  memset(n->flag_prev, 0, sizeof(n->flag_prev));
+  n->z_above = NULL;
+  n->z_below = NULL;
+  n->z_rank = 0U;
   return n;
 }
 
 static void delete_node(Node *n) {
   if (!n)
     return;
-  free(n);
+  NeuroTypePoolFree(&stack_set_.node_pool, n);
   n = NULL;
 }
 
@@ -120,114 +705,173 @@ static void set_curr_node(Node *n) {
   s->curr = n;
 }
 
-static NeuroClient *remove_last_node(Stack *s) {
+static void unlink_z_node(Stack *s, Node *n) {
   assert(s);
-  if (s->size < 1)
-    return NULL;
-  Node *const t = s->last;
-  const bool update_nsp = t->cli->is_nsp;
-  if (s->size == 1) {
+  assert(n);
+  if (n->z_above)
+    n->z_above->z_below = n->z_below;
+  else
+    s->z_top = n->z_below;
+  if (n->z_below)
+    n->z_below->z_above = n->z_above;
+  n->z_above = NULL;
+  n->z_below = NULL;
+}
+
+static void push_z_node(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  n->z_above = NULL;
+  n->z_below = s->z_top;
+  n->z_rank = ++s->z_last_rank;
+  if (s->z_top)
+    s->z_top->z_above = n;
+  s->z_top = n;
+}
+
+static void link_node_end(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  if (n->cli->is_nsp)
+    s->nsp = n;
+  if (s->size < 1) {
+    s->head = n;
+    s->last = n;
+  } else {
+    n->prev = s->curr;
+    if (s->curr->next)
+      s->curr->next->prev = n;
+    else
+      s->last = n;
+    n->next = s->curr->next;
+    s->curr->next = n;
+  }
+  set_curr_node(n);
+  link_node_handle(s, n);
+  s->size++;
+  sync_node_flags(n);
+  s->spatial_index.is_dirty = true;
+  push_z_node(s, n);
+  s->is_z_dirty = true;  // Its window was not restacked with the ones of the stack yet
+}
+
+static void link_node_start(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  if (n->cli->is_nsp)
+    s->nsp = n;
+  if (s->size < 1) {
+    s->head = n;
+    s->last = n;
+  } else {
+    n->next = s->curr;
+    if (s->curr->prev)
+      s->curr->prev->next = n;
+    else
+      s->head = n;
+    n->prev = s->curr->prev;
+    s->curr->prev = n;
+  }
+  set_curr_node(n);
+  link_node_handle(s, n);
+  s->size++;
+  sync_node_flags(n);
+  s->spatial_index.is_dirty = true;
+  push_z_node(s, n);
+  s->is_z_dirty = true;  // Its window was not restacked with the ones of the stack yet
+}
+
+// Unlinks the node from its stack without freeing it
+static void unlink_node(Node *n) {
+  assert(n);
+  Stack *const s = stack_set_.stack_list + n->cli->ws;
+  if (s->size == 1U) {
     s->head = NULL;
     s->last = NULL;
     s->curr = NULL;
+  } else if (n == s->last) {
+    set_curr_node(n->prev);
+    n->prev->next = NULL;
+    s->last = n->prev;
   } else {
-    set_curr_node(s->last->prev);
-    s->last->prev->next = NULL;
-    s->last = t->prev;
+    set_curr_node(n->next);
+    if (n == s->head) {
+      s->head = n->next;
+      n->next->prev = NULL;
+    } else {
+      n->prev->next = n->next;
+      n->next->prev = n->prev;
+    }
   }
-  NeuroClient *const ret = t->cli;
-  delete_node(t);
+  if (s->prev == n)
+    s->prev = NULL;
+  unlink_node_flags(n);
+  unlink_z_node(s, n);
+  unlink_node_handle(s, n);
+  n->next = NULL;
+  n->prev = NULL;
   s->size--;
-  if (update_nsp)
+  s->spatial_index.is_dirty = true;
+  if (n->cli->is_nsp)
     update_nsp_stack(s);
-  return ret;
 }
 
-static NeuroClient *remove_no_last_node(Node *n) {
+static NeuroClient *remove_node(Node *n) {
   assert(n);
-  Stack *const s = stack_set_.stack_list + n->cli->ws;
-  if (s->size == 0U || s->last == n)
-    return NULL;
-  const bool update_nsp = n->cli->is_nsp;
-  set_curr_node(n->next);
-  if (n == s->head) {
-    s->head = n->next;
-    n->next->prev = NULL;
-  } else {
-    n->prev->next = n->next;
-    n->next->prev = n->prev;
-  }
+  unlink_node(n);
   NeuroClient *const ret = n->cli;
+  remove_window_entry(&stack_set_.window_index, ret->win);
   delete_node(n);
-  s->size--;
-  if (update_nsp)
-    update_nsp_stack(s);
   return ret;
 }
 
-static bool update_minimized_clients_size(Stack *s, NeuroIndex new_total) {
-  if (!s)
-    return false;
-
-  // Get the new needed size
-  NeuroIndex new_size = STEP_SIZE_REALLOC;
-  while (new_size < new_total)
-    new_size += STEP_SIZE_REALLOC;
-
-  // Realoc if it is different than the current allocated size
-  if (new_size != s->minimized_size) {
-    s->minimized_clients = (NeuroClient **)realloc(s->minimized_clients, new_size*sizeof(void *));
-    if (!s->minimized_clients)
-      return false;
-    s->minimized_size = new_size;
-  }
-  return true;
-}
-
 static NeuroClient *push_minimized_client(Stack *s, NeuroClient *c) {
   if (!s || !c)
     return NULL;
 
-  // Realoc memory if needed
-  const NeuroIndex new_total = s->num_minimized + 1;
-  if (!update_minimized_clients_size(s, new_total))
+  // Index the client
+  Node *const n = new_node(c);
+  if (!n)
     return NULL;
+  if (!insert_window_entry(&stack_set_.window_index, c->win, n, true)) {
+    delete_node(n);
+    return NULL;
+  }
 
-  // Store the client
-  s->num_minimized = new_total;
-  s->minimized_clients[ new_total - 1 ] = c;
+  // Append it to the minimized list
+  n->prev = s->minimized_last;
+  if (s->minimized_last)
+    s->minimized_last->next = n;
+  else
+    s->minimized_head = n;
+  s->minimized_last = n;
+  s->num_minimized++;
   return c;
 }
 
-static NeuroClient *pop_minimized_client(Stack *s) {
-  if (!s || s->num_minimized == 0)
-    return NULL;
-
-  // Realloc memory if needed
-  const NeuroIndex new_count = s->num_minimized - 1;
-  if (!update_minimized_clients_size(s, new_count))
-    return NULL;
+static NeuroClient *remove_minimized_node(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  if (n->prev)
+    n->prev->next = n->next;
+  else
+    s->minimized_head = n->next;
+  if (n->next)
+    n->next->prev = n->prev;
+  else
+    s->minimized_last = n->prev;
+  s->num_minimized--;
 
-  NeuroClient *const cli = s->minimized_clients[ new_count ];
-  s->num_minimized = new_count;
-  return cli;
+  NeuroClient *const ret = n->cli;
+  remove_window_entry(&stack_set_.window_index, ret->win);
+  delete_node(n);
+  return ret;
 }
 
-static NeuroClient *remove_minimized_client(Stack *s, Window w) {
-  if (!s)
+static NeuroClient *pop_minimized_client(Stack *s) {
+  if (!s || !s->minimized_last)
     return NULL;
-
-  NeuroClient *found = NULL;
-  for (NeuroIndex i = 0U; i < s->num_minimized; ++i) {
-    NeuroClient *const c = s->minimized_clients[ i ];
-    if (found)
-      s->minimized_clients[ i-1 ] = c;
-    if (c->win == w)
-      found = c;
-  }
-  if (found)
-    s->num_minimized--;
-  return found;
+  return remove_minimized_node(s, s->minimized_last);
 }
 
 static void set_layouts(NeuroLayout *layout, const NeuroLayoutConf *const *layout_conf, NeuroIndex size) {
@@ -267,10 +911,6 @@ static bool init_stack(Stack *s, const char *name, const NeuroLayoutConf *const
   if (!s->toggled_layouts)
     return false;
 
-  s->minimized_clients = (NeuroClient **)calloc(STEP_SIZE_REALLOC, sizeof(void *));
-  if (!s->minimized_clients)
-    return false;
-
   // Set clients
   s->curr = NULL;
   s->prev = NULL;
@@ -279,7 +919,21 @@ static bool init_stack(Stack *s, const char *name, const NeuroLayoutConf *const
   s->nsp = NULL;
   s->size = 0;
   s->num_minimized = 0;
-  s->minimized_size = STEP_SIZE_REALLOC;
+  s->minimized_head = NULL;
+  s->minimized_last = NULL;
+  memset(s->flag_heads, 0, sizeof(s->flag_heads));
+  memset(s->flag_counts, 0, sizeof(s->flag_counts));
+  memset(&s->spatial_index, 0, sizeof(SpatialIndex));
+  s->spatial_index.is_dirty = true;
+  s->regions = NULL;
+  s->float_regions = NULL;
+  s->handle_nodes = NULL;
+  s->handles_size = 0U;
+  memset(&s->arrange, 0, sizeof(NeuroArrange));
+  s->z_top = NULL;
+  s->z_last_rank = 0U;
+  s->is_z_dirty = false;
+  s->arranged_monitor = NULL;
 
   // Set the layouts
   s->curr_layout_index = 0U;
@@ -302,14 +956,25 @@ static void stop_stack(Stack *s) {
 
   // Remove clients
   NeuroClient *c = NULL;
-  while ((c = remove_last_node(s)))
+  while (s->last) {
+    c = remove_node(s->last);
     NeuroTypeDeleteClient(c);
+  }
 
   // Remove minimized clients
   while ((c = pop_minimized_client(s)))
     NeuroTypeDeleteClient(c);
-  free(s->minimized_clients);
-  s->minimized_clients = NULL;
+
+  // Remove the spatial index and the arrange regions
+  stop_spatial_index(&s->spatial_index);
+  free(s->regions);
+  s->regions = NULL;
+  free(s->float_regions);
+  s->float_regions = NULL;
+  free(s->handle_nodes);
+  s->handle_nodes = NULL;
+  s->handles_size = 0U;
+  memset(&s->arrange, 0, sizeof(NeuroArrange));
 
   // Remove layouts
   free(s->layouts);
@@ -347,11 +1012,24 @@ bool NeuroCoreInit(void) {
   if (!stack_set_.stack_list)
     return false;
 
+  // Initialize the node and client pools
+  if (!NeuroTypePoolInit(&stack_set_.node_pool, sizeof(Node), NODE_POOL_CHUNK_ITEMS))
+    return false;
+  if (!NeuroTypeInit())
+    return false;
+
   // Initialize the stack set
   stack_set_.curr = 0U;
   stack_set_.old = 0U;
   stack_set_.size = size;
 
+  // Initialize the window index
+  stack_set_.window_index.entries = NULL;
+  stack_set_.window_index.size = 0U;
+  stack_set_.window_index.count = 0U;
+  if (!resize_window_index(&stack_set_.window_index, WINDOW_INDEX_MIN_SIZE))
+    return false;
+
   // Initialize the stacks
   for (NeuroIndex i = 0U; workspace_list[ i ]; ++i) {
     const NeuroWorkspace *const ws = workspace_list[ i ];
@@ -379,6 +1057,21 @@ void NeuroCoreStop(void) {
   // Remove the stack list
   delete_stack_list(stack_set_.stack_list);
   stack_set_.stack_list = NULL;
+
+  // Remove the window index
+  free(stack_set_.window_index.entries);
+  stack_set_.window_index.entries = NULL;
+  stack_set_.window_index.size = 0U;
+  stack_set_.window_index.count = 0U;
+
+  // Remove the node and client pools
+  NeuroTypePoolStop(&stack_set_.node_pool);
+  NeuroTypeStop();
+}
+
+void NeuroCoreGetPoolStats(NeuroPoolStats *node_stats, NeuroPoolStats *client_stats) {
+  NeuroTypePoolGetStats(&stack_set_.node_pool, node_stats);
+  NeuroTypeGetClientPoolStats(client_stats);
 }
 
 NeuroIndex NeuroCoreGetHeadStack(void) {
@@ -457,6 +1150,41 @@ NeuroClientPtrPtr NeuroCoreFindClient(const NeuroClientTesterFn ctf, const void
   return NULL;
 }
 
+NeuroClientPtrPtr NeuroCoreFindWindowClient(Window w) {
+  const WindowEntry *const e = find_window_entry(&stack_set_.window_index, w);
+  return e && !e->is_minimized ? (NeuroClientPtrPtr)e->node : NULL;
+}
+
+// First, search in the current stack, if it is not there, search in the other stacks
+NeuroClientPtrPtr NeuroCoreFindFlagClient(NeuroClientFlag f) {
+  NeuroClientPtrPtr c = NeuroCoreStackGetFlagClient(stack_set_.curr, f);
+  if (c)
+    return c;
+  for (NeuroIndex i = 0U; i < stack_set_.size; ++i) {
+    if (i == stack_set_.curr)
+      continue;
+    c = NeuroCoreStackGetFlagClient(i, f);
+    if (c)
+      return c;
+  }
+  return NULL;
+}
+
+// First, search in the current stack, if it is not there, search in the other stacks
+NeuroClientPtrPtr NeuroCoreFindPointedClient(const NeuroPoint *p) {
+  NeuroClientPtrPtr c = NeuroCoreStackFindPointedClient(stack_set_.curr, p);
+  if (c)
+    return c;
+  for (NeuroIndex i = 0U; i < stack_set_.size; ++i) {
+    if (i == stack_set_.curr)
+      continue;
+    c = NeuroCoreStackFindPointedClient(i, p);
+    if (c)
+      return c;
+  }
+  return NULL;
+}
+
 // First, search in the current stack, if is not there, search in the other stacks
 NeuroClientPtrPtr NeuroCoreFindNspClient(void) {
   Node *n = stack_set_.stack_list[ stack_set_.curr ].nsp;
@@ -475,54 +1203,34 @@ NeuroClientPtrPtr NeuroCoreFindNspClient(void) {
 NeuroClientPtrPtr NeuroCoreAddClientEnd(NeuroClient *c) {
   if (!c)
     return NULL;
-  Stack *const s = stack_set_.stack_list + c->ws;
+  Stack *const s = stack_set_.stack_list + (c->ws % stack_set_.size);
+  if (!reserve_handles(s, s->size + 1U))
+    return NULL;
   Node *const n = new_node(c);
   if (!n)
     return NULL;
-  if (c->is_nsp)
-    s->nsp = n;
-  if (s->size < 1) {
-    s->head = n;
-    s->last = n;
-    set_curr_node(n);
-  } else {
-    n->prev = s->curr;
-    if (s->curr->next)
-      s->curr->next->prev = n;
-    else
-      s->last = n;
-    n->next = s->curr->next;
-    s->curr->next = n;
-    set_curr_node(n);
+  if (!insert_window_entry(&stack_set_.window_index, c->win, n, false)) {
+    delete_node(n);
+    return NULL;
   }
-  s->size++;
+  link_node_end(stack_set_.stack_list + c->ws, n);
   return (NeuroClientPtrPtr)n;
 }
 
 NeuroClientPtrPtr NeuroCoreAddClientStart(NeuroClient *c) {
   if (!c)
     return NULL;
-  Stack *const s = stack_set_.stack_list + c->ws;
+  Stack *const s = stack_set_.stack_list + (c->ws % stack_set_.size);
+  if (!reserve_handles(s, s->size + 1U))
+    return NULL;
   Node *const n = new_node(c);
   if (!n)
     return NULL;
-  if (c->is_nsp)
-    s->nsp = n;
-  if (s->size < 1) {
-    s->head = n;
-    s->last = n;
-    set_curr_node(n);
-  } else {
-    n->next = s->curr;
-    if (s->curr->prev)
-      s->curr->prev->next = n;
-    else
-      s->head = n;
-    n->prev = s->curr->prev;
-    s->curr->prev = n;
-    set_curr_node(n);
+  if (!insert_window_entry(&stack_set_.window_index, c->win, n, false)) {
+    delete_node(n);
+    return NULL;
   }
-  s->size++;
+  link_node_start(stack_set_.stack_list + c->ws, n);
   return (NeuroClientPtrPtr)n;
 }
 
@@ -531,8 +1239,21 @@ NeuroClient *NeuroCoreRemoveClient(NeuroClientPtrPtr c) {
   if (!c)
     return NULL;
 
-  return NeuroCoreClientIsLast(c) ? remove_last_node(stack_set_.stack_list + NEURO_CLIENT_PTR(c)->ws) :
-      remove_no_last_node((Node *)c);
+  return remove_node((Node *)c);
+}
+
+// Relinks the node at the start of the new stack, so that only the region arrays of the new stack might grow
+NeuroClientPtrPtr NeuroCoreMoveClient(NeuroClientPtrPtr c, NeuroIndex ws) {
+  if (!c)
+    return NULL;
+  Node *const n = (Node *)c;
+  Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  if (!reserve_handles(s, s->size + 1U))
+    return NULL;
+  unlink_node(n);
+  n->cli->ws = ws % stack_set_.size;
+  link_node_start(s, n);
+  return c;
 }
 
 NeuroClient *NeuroCorePushMinimizedClient(NeuroClient *c) {
@@ -548,20 +1269,11 @@ NeuroClient *NeuroCorePopMinimizedClient(NeuroIndex ws) {
   return pop_minimized_client(s);
 }
 
-// First, search in the current stack, if is not there, search in the other stacks
 NeuroClient *NeuroCoreRemoveMinimizedClient(Window w) {
-  Stack *const s = stack_set_.stack_list + stack_set_.curr;
-  NeuroClient *c = remove_minimized_client(s, w);
-  if (c)
-    return c;
-  for (NeuroIndex i = 0U; i < stack_set_.size; ++i) {
-    if (i == stack_set_.curr)
-      continue;
-    c = remove_minimized_client(stack_set_.stack_list + i, w);
-    if (c)
-      return c;
-  }
-  return NULL;
+  const WindowEntry *const e = find_window_entry(&stack_set_.window_index, w);
+  if (!e || !e->is_minimized)
+    return NULL;
+  return remove_minimized_node(stack_set_.stack_list + (e->node->cli->ws % stack_set_.size), e->node);
 }
 
 bool NeuroCoreStackIsCurr(NeuroIndex ws) {
@@ -606,6 +1318,11 @@ NeuroIndex NeuroCoreStackGetMinimizedNum(NeuroIndex ws) {
   return stack_set_.stack_list[ ws % stack_set_.size ].num_minimized;
 }
 
+// The minimized clients are iterated with NeuroCoreClientGetNext, in the order they were minimized
+NeuroClientPtrPtr NeuroCoreStackGetMinimizedHeadClient(NeuroIndex ws) {
+  return (NeuroClientPtrPtr)(stack_set_.stack_list[ ws % stack_set_.size ].minimized_head);
+}
+
 NeuroIndex NeuroCoreStackGetNumLayouts(NeuroIndex ws) {
   const Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
   return s->is_toggled_layout ? s->num_toggled_layouts : s->num_layouts;
@@ -692,6 +1409,88 @@ NeuroClientPtrPtr NeuroCoreStackFindClient(NeuroIndex ws, const NeuroClientTeste
   return NULL;
 }
 
+NeuroClientPtrPtr NeuroCoreStackGetFlagClient(NeuroIndex ws, NeuroClientFlag f) {
+  if (f >= NEURO_CLIENT_FLAG_END)
+    return NULL;
+  return (NeuroClientPtrPtr)(stack_set_.stack_list[ ws % stack_set_.size ].flag_heads[ f ]);
+}
+
+NeuroIndex NeuroCoreStackGetFlagNum(NeuroIndex ws, NeuroClientFlag f) {
+  if (f >= NEURO_CLIENT_FLAG_END)
+    return 0U;
+  return stack_set_.stack_list[ ws % stack_set_.size ].flag_counts[ f ];
+}
+
+// Returns the topmost client whose region has the point
+NeuroClientPtrPtr NeuroCoreStackFindPointedClient(NeuroIndex ws, const NeuroPoint *p) {
+  if (!p)
+    return NULL;
+  return (NeuroClientPtrPtr)find_pointed_node(stack_set_.stack_list + (ws % stack_set_.size), p);
+}
+
+// Returns the closest client in direction d that overlaps the client along the facing edge
+NeuroClientPtrPtr NeuroCoreStackFindNearestClient(NeuroIndex ws, const NeuroClientPtrPtr c, NeuroDirection d) {
+  if (!c)
+    return NULL;
+  return (NeuroClientPtrPtr)find_nearest_node(stack_set_.stack_list + (ws % stack_set_.size), (const Node *)c, d);
+}
+
+// Moves the handles of the clients that pass the tester to the front of the region arrays, in stack order, and returns
+// the arrange of the stack viewing them. Nothing is moved while the order and the tested clients do not change, and the
+// arrangers write the regions of the clients in place. The arrange belongs to the stack and is reused by the next run
+NeuroArrange *NeuroCoreStackGatherRegions(NeuroIndex ws, const NeuroClientTesterFn ctf) {
+  assert(ctf);
+  Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  NeuroIndex i = 0U;
+  for (Node *n = s->head; n; n = n->next) {
+    if (!ctf((NeuroClientPtrPtr)n, NULL))
+      continue;
+    if (n->handle != i)  // The handles below i belong to the previous tested nodes, so n->handle is above i
+      swap_handles(s, n->handle, i);
+    ++i;
+  }
+  NeuroArrange *const a = &s->arrange;
+  a->size = i;
+  a->client_regions = s->regions;
+  a->client_float_regions = s->float_regions;
+  return a;
+}
+
+// Must be called after changing the regions of the clients of the stack
+void NeuroCoreStackInvalidateRegions(NeuroIndex ws) {
+  stack_set_.stack_list[ ws % stack_set_.size ].spatial_index.is_dirty = true;
+}
+
+NeuroClientPtrPtr NeuroCoreStackGetTopClient(NeuroIndex ws) {
+  return (NeuroClientPtrPtr)stack_set_.stack_list[ ws % stack_set_.size ].z_top;
+}
+
+bool NeuroCoreStackIsStackingDirty(NeuroIndex ws) {
+  return stack_set_.stack_list[ ws % stack_set_.size ].is_z_dirty;
+}
+
+// Must be called when the stacking order of the X server was changed without restacking the stack
+void NeuroCoreStackSetStackingDirty(NeuroIndex ws, bool is_dirty) {
+  stack_set_.stack_list[ ws % stack_set_.size ].is_z_dirty = is_dirty;
+}
+
+// Whether the stack must be arranged before it is shown, hidden stacks are never dirty until they get a monitor
+bool NeuroCoreStackIsLayoutDirty(NeuroIndex ws) {
+  const Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  return s->monitor && s->monitor != s->arranged_monitor;
+}
+
+// Stacks without monitor are not arranged until they get one, see NeuroLayoutRun
+void NeuroCoreStackSetLayoutDirty(NeuroIndex ws, bool is_dirty) {
+  Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  s->arranged_monitor = is_dirty ? NULL : s->monitor;
+}
+
+NeuroClientPtrPtr NeuroCoreStackFindWindowClient(NeuroIndex ws, Window w) {
+  const NeuroClientPtrPtr c = NeuroCoreFindWindowClient(w);
+  return c && NEURO_CLIENT_PTR(c)->ws == ws % stack_set_.size ? c : NULL;
+}
+
 // Client
 bool NeuroCoreClientIsCurr(const NeuroClientPtrPtr c) {
   return c && (Node *)c == stack_set_.stack_list[ NEURO_CLIENT_PTR(c)->ws ].curr;
@@ -709,9 +1508,21 @@ bool NeuroCoreClientIsLast(const NeuroClientPtrPtr c) {
   return c && (Node *)c == stack_set_.stack_list[ NEURO_CLIENT_PTR(c)->ws ].last;
 }
 
+// The regions are stored in the arrays of the stack, so the pointer is only valid until clients are added, removed or
+// moved, or the stack is arranged
 NeuroRectangle *NeuroCoreClientGetRegion(const NeuroClientPtrPtr c) {
-  Node *const n = (Node *)c;
-  return !c ? NULL : &n->region;
+  const Node *const n = (const Node *)c;
+  if (!c || n->handle == NODE_NO_HANDLE)
+    return NULL;
+  return get_node_region(stack_set_.stack_list + n->cli->ws, n);
+}
+
+// Same as NeuroCoreClientGetRegion, the float region goes back to the client when it leaves the stack
+NeuroRectangle *NeuroCoreClientGetFloatRegion(const NeuroClientPtrPtr c) {
+  const Node *const n = (const Node *)c;
+  if (!c || n->handle == NODE_NO_HANDLE)
+    return NULL;
+  return stack_set_.stack_list[ n->cli->ws ].float_regions + n->handle;
 }
 
 NeuroClientPtrPtr NeuroCoreClientGetNext(const NeuroClientPtrPtr c) {
@@ -722,14 +1533,64 @@ NeuroClientPtrPtr NeuroCoreClientGetPrev(const NeuroClientPtrPtr c) {
   return !c ? NULL : (NeuroClientPtrPtr)(((Node *)c)->prev);
 }
 
+NeuroClientPtrPtr NeuroCoreClientGetBelow(const NeuroClientPtrPtr c) {
+  return !c ? NULL : (NeuroClientPtrPtr)(((Node *)c)->z_below);
+}
+
+// Moves the client to the top of the stacking order of its stack, it does not restack its window
+void NeuroCoreClientRaise(NeuroClientPtrPtr c) {
+  if (!c)
+    return;
+  Node *const n = (Node *)c;
+  Stack *const s = stack_set_.stack_list + n->cli->ws;
+  if (s->z_top == n)
+    return;
+  unlink_z_node(s, n);
+  push_z_node(s, n);
+}
+
 NeuroClientPtrPtr NeuroCoreClientSwap(const NeuroClientPtrPtr c1, const NeuroClientPtrPtr c2) {
   if (!c1 || !c2 || c1 == c2)
     return NULL;
   Node *const n1 = (Node *)c1;
   Node *const n2 = (Node *)c2;
+  unlink_node_flags(n1);
+  unlink_node_flags(n2);
   NeuroClient *const t = n1->cli;
   n1->cli = n2->cli;
   n2->cli = t;
+  NeuroRectangle *const fr1 = NeuroCoreClientGetFloatRegion(c1);
+  NeuroRectangle *const fr2 = NeuroCoreClientGetFloatRegion(c2);
+  const NeuroRectangle fr = *fr1;  // The float regions belong to the clients, the regions to the nodes
+  *fr1 = *fr2;
+  *fr2 = fr;
+  insert_window_entry(&stack_set_.window_index, n1->cli->win, n1, false);
+  insert_window_entry(&stack_set_.window_index, n2->cli->win, n2, false);
+  sync_node_flags(n1);
+  sync_node_flags(n2);
+  stack_set_.stack_list[ n1->cli->ws ].is_z_dirty = true;  // The windows swapped their place in the stacking order
+  stack_set_.stack_list[ n2->cli->ws ].is_z_dirty = true;
   return c2;
 }
 
+void NeuroCoreClientSetUrgent(NeuroClientPtrPtr c, bool is_urgent) {
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->is_urgent = is_urgent;
+  sync_node_flags((Node *)c);
+}
+
+void NeuroCoreClientSetFullscreen(NeuroClientPtrPtr c, bool is_fullscreen) {
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->is_fullscreen = is_fullscreen;
+  sync_node_flags((Node *)c);
+}
+
+void NeuroCoreClientSetFreeSetter(NeuroClientPtrPtr c, NeuroFreeSetterFn fsf) {
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->free_setter_fn = fsf;
+  sync_node_flags((Node *)c);
+}
+
@@ -24,6 +24,7 @@
 // StackSet
 bool NeuroCoreInit(void);
 void NeuroCoreStop(void);
+void NeuroCoreGetPoolStats(NeuroPoolStats *node_stats, NeuroPoolStats *client_stats);
 NeuroIndex NeuroCoreGetHeadStack(void);
 NeuroIndex NeuroCoreGetLastStack(void);
 NeuroIndex NeuroCoreGetCurrStack(void);
@@ -38,10 +39,14 @@ NeuroClientPtrPtr NeuroCoreGetCurrClientNspStack(void);
 void NeuroCoreSetCurrStack(NeuroIndex ws);
 void NeuroCoreSetCurrClient(NeuroClientPtrPtr c);
 NeuroClientPtrPtr NeuroCoreFindClient(const NeuroClientTesterFn ctf, const void *data);
+NeuroClientPtrPtr NeuroCoreFindWindowClient(Window w);
+NeuroClientPtrPtr NeuroCoreFindFlagClient(NeuroClientFlag f);
+NeuroClientPtrPtr NeuroCoreFindPointedClient(const NeuroPoint *p);
 NeuroClientPtrPtr NeuroCoreFindNspClient(void);
 NeuroClientPtrPtr NeuroCoreAddClientEnd(NeuroClient *c);
 NeuroClientPtrPtr NeuroCoreAddClientStart(NeuroClient *c);
 NeuroClient *NeuroCoreRemoveClient(NeuroClientPtrPtr c);
+NeuroClientPtrPtr NeuroCoreMoveClient(NeuroClientPtrPtr c, NeuroIndex ws);
 NeuroClient *NeuroCorePushMinimizedClient(NeuroClient *c);
 NeuroClient *NeuroCorePopMinimizedClient(NeuroIndex ws);
 NeuroClient *NeuroCoreRemoveMinimizedClient(Window w);
@@ -55,6 +60,7 @@ void NeuroCoreStackSetMonitor(NeuroIndex ws, const NeuroMonitor *m);
 const char *NeuroCoreStackGetName(NeuroIndex ws);
 NeuroIndex NeuroCoreStackGetSize(NeuroIndex ws);
 NeuroIndex NeuroCoreStackGetMinimizedNum(NeuroIndex ws);
+NeuroClientPtrPtr NeuroCoreStackGetMinimizedHeadClient(NeuroIndex ws);
 NeuroIndex NeuroCoreStackGetNumLayouts(NeuroIndex ws);
 NeuroIndex NeuroCoreStackGetLayoutIdx(NeuroIndex ws);
 bool NeuroCoreStackIsCurrToggledLayout(NeuroIndex ws);
@@ -71,6 +77,18 @@ NeuroClientPtrPtr NeuroCoreStackGetPrevClient(NeuroIndex ws);
 NeuroClientPtrPtr NeuroCoreStackGetHeadClient(NeuroIndex ws);
 NeuroClientPtrPtr NeuroCoreStackGetLastClient(NeuroIndex ws);
 NeuroClientPtrPtr NeuroCoreStackFindClient(NeuroIndex ws, const NeuroClientTesterFn ctf, const void *p);
+NeuroClientPtrPtr NeuroCoreStackGetFlagClient(NeuroIndex ws, NeuroClientFlag f);
+NeuroIndex NeuroCoreStackGetFlagNum(NeuroIndex ws, NeuroClientFlag f);
+NeuroClientPtrPtr NeuroCoreStackFindPointedClient(NeuroIndex ws, const NeuroPoint *p);
+NeuroClientPtrPtr NeuroCoreStackFindNearestClient(NeuroIndex ws, const NeuroClientPtrPtr c, NeuroDirection d);
+NeuroArrange *NeuroCoreStackGatherRegions(NeuroIndex ws, const NeuroClientTesterFn ctf);
+void NeuroCoreStackInvalidateRegions(NeuroIndex ws);
+NeuroClientPtrPtr NeuroCoreStackGetTopClient(NeuroIndex ws);
+bool NeuroCoreStackIsStackingDirty(NeuroIndex ws);
+void NeuroCoreStackSetStackingDirty(NeuroIndex ws, bool is_dirty);
+bool NeuroCoreStackIsLayoutDirty(NeuroIndex ws);
+void NeuroCoreStackSetLayoutDirty(NeuroIndex ws, bool is_dirty);
+NeuroClientPtrPtr NeuroCoreStackFindWindowClient(NeuroIndex ws, Window w);
 
 // Client
 bool NeuroCoreClientIsCurr(const NeuroClientPtrPtr c);
@@ -78,7 +96,13 @@ bool NeuroCoreClientIsPrev(const NeuroClientPtrPtr c);
 bool NeuroCoreClientIsHead(const NeuroClientPtrPtr c);
 bool NeuroCoreClientIsLast(const NeuroClientPtrPtr c);
 NeuroRectangle *NeuroCoreClientGetRegion(const NeuroClientPtrPtr c);
+NeuroRectangle *NeuroCoreClientGetFloatRegion(const NeuroClientPtrPtr c);
 NeuroClientPtrPtr NeuroCoreClientGetNext(const NeuroClientPtrPtr c);
 NeuroClientPtrPtr NeuroCoreClientGetPrev(const NeuroClientPtrPtr c);
+NeuroClientPtrPtr NeuroCoreClientGetBelow(const NeuroClientPtrPtr c);
+void NeuroCoreClientRaise(NeuroClientPtrPtr c);
 NeuroClientPtrPtr NeuroCoreClientSwap(const NeuroClientPtrPtr c1, const NeuroClientPtrPtr c2);
+void NeuroCoreClientSetUrgent(NeuroClientPtrPtr c, bool is_urgent);
+void NeuroCoreClientSetFullscreen(NeuroClientPtrPtr c, bool is_fullscreen);
+void NeuroCoreClientSetFreeSetter(NeuroClientPtrPtr c, NeuroFreeSetterFn fsf);
 
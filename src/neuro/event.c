@@ -25,50 +25,281 @@
 #include "action.h"
 #include "monitor.h"
 
+// Defines
+#define EVENT_TYPE_NONE 0  // Not used by X, marks the events dropped when coalescing a batch
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// EventPending (work on a workspace deferred to the end of the event batch)
+enum EventPending {
+  EVENT_PENDING_NULL = 0,
+  EVENT_PENDING_LAYOUT = 1 << 0,  // Run the layout and update the clients
+  EVENT_PENDING_FOCUS = 1 << 1    // Focus the current client
+};
+typedef enum EventPending EventPending;
+
+// PendingInfo
+typedef struct PendingInfo PendingInfo;
+struct PendingInfo {
+  unsigned int *stacks;  // Bit mask of EventPending of each workspace
+  NeuroIndex num_stacks;
+  bool is_panel_dirty;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+static PendingInfo pending_info_ = { NULL, 0U, false };
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-static void do_key_press(XEvent *e) {
-  assert(e);
-  const NeuroKey *const *const key_list = NeuroConfigGet()->key_list;
-  if (!key_list)
+static void set_pending(NeuroIndex ws, EventPending ep) {
+  if (!pending_info_.stacks)
     return;
+  pending_info_.stacks[ ws % pending_info_.num_stacks ] |= ep;
+}
+
+// Runs the work deferred by the handlers, once per workspace
+static void flush_pending(void) {
+  bool is_pending = false;
 
-  const XKeyEvent ke = e->xkey;
-  int ks = 0;
-  KeySym *const key_sym = XGetKeyboardMapping(NeuroSystemGetDisplay(), ke.keycode, 1, &ks);
-  for (NeuroIndex i = 0U; key_list[ i ]; ++i) {
-    const NeuroKey *k = key_list[ i ];
-    if (k->key == *key_sym && k->mod == ke.state) {
-      NeuroActionRunActionChain(&k->action_chain);
-      NeuroDzenRefresh(true);
+  // Arrange first, the update maps new windows in their final place (or leaves them unmapped if they are hidden)
+  for (NeuroIndex i = 0U; i < pending_info_.num_stacks; ++i) {
+    if (pending_info_.stacks[ i ] & EVENT_PENDING_LAYOUT) {
+      NeuroLayoutRunCurr(i);
+      NeuroWorkspaceUpdate(i);
     }
   }
-  XFree(key_sym);
+
+  for (NeuroIndex i = 0U; i < pending_info_.num_stacks; ++i) {
+    if (pending_info_.stacks[ i ] == EVENT_PENDING_NULL)
+      continue;
+    if (pending_info_.stacks[ i ] & EVENT_PENDING_FOCUS)
+      NeuroWorkspaceFocus(i);
+    pending_info_.stacks[ i ] = EVENT_PENDING_NULL;
+    is_pending = true;
+  }
+  if (is_pending)
+    NeuroSystemIgnoreEnterNotify();
+
+  if (pending_info_.is_panel_dirty) {
+    NeuroDzenRefresh(true);
+    pending_info_.is_panel_dirty = false;
+  }
 }
 
-static void do_button_press(XEvent *e) {
+// Merges the configure request e into the later one l, which wins on the values both of them set
+static void merge_configure_request(XConfigureRequestEvent *l, const XConfigureRequestEvent *e) {
+  assert(l);
   assert(e);
-  const NeuroButton *const *const button_list = NeuroConfigGet()->button_list;
-  if (!button_list)
+  const unsigned long mask = e->value_mask & ~l->value_mask;
+  if (mask & CWX)
+    l->x = e->x;
+  if (mask & CWY)
+    l->y = e->y;
+  if (mask & CWWidth)
+    l->width = e->width;
+  if (mask & CWHeight)
+    l->height = e->height;
+  if (mask & CWBorderWidth)
+    l->border_width = e->border_width;
+  l->value_mask |= e->value_mask & ~(unsigned long)(CWSibling|CWStackMode);
+
+  // Sibling and stack mode form one restack, so they are never taken from different requests
+  if (!(l->value_mask & (CWSibling|CWStackMode))) {
+    l->above = e->above;
+    l->detail = e->detail;
+    l->value_mask |= e->value_mask & (CWSibling|CWStackMode);
+  }
+}
+
+// Drops the events superseded by later ones in the same batch
+static void coalesce_events(XEvent *events, NeuroIndex n) {
+  assert(events);
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    XEvent *const e = events + i;
+    for (NeuroIndex j = i + 1U; j < n && e->type != EVENT_TYPE_NONE; ++j) {
+      XEvent *const l = events + j;
+      if (e->type == MotionNotify && (l->type == ButtonPress || l->type == ButtonRelease))
+        break;  // A drag ends or starts in between
+      if (e->type == EnterNotify && (l->type == KeyPress || l->type == KeyRelease || l->type == ButtonPress ||
+          l->type == ButtonRelease))
+        break;  // The binding in between must run with the focus set by this crossing
+      if (l->type != e->type)
+        continue;
+      if (e->type == PropertyNotify && l->xproperty.window == e->xproperty.window &&
+          l->xproperty.atom == e->xproperty.atom) {
+        e->type = EVENT_TYPE_NONE;
+      } else if (e->type == ConfigureRequest && l->xconfigurerequest.window == e->xconfigurerequest.window) {
+        merge_configure_request(&l->xconfigurerequest, &e->xconfigurerequest);
+        e->type = EVENT_TYPE_NONE;
+      } else if (e->type == EnterNotify || e->type == MotionNotify) {  // Only the last pointer position matters
+        e->type = EVENT_TYPE_NONE;
+      }
+    }
+  }
+}
+
+// Only free clients and the ones in a floating layout can choose their geometry
+static bool is_configurable_client(const NeuroClientPtrPtr c) {
+  assert(c);
+  const NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  if (client->is_fullscreen)
+    return false;
+  return client->free_setter_fn != NeuroRuleFreeSetterNull ||
+      NeuroCoreStackGetCurrLayout(client->ws)->arranger_fn == NeuroLayoutArrangerFloat;
+}
+
+// Stores the requested geometry, so that the next layout run keeps it instead of fighting the client
+static void set_requested_region(NeuroClientPtrPtr c, const XConfigureRequestEvent *ev) {
+  assert(c);
+  assert(ev);
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  const NeuroLayout *const l = NeuroCoreStackGetCurrLayout(client->ws);
+  const int border = l->border_width_setter_fn(c) + l->border_gap_setter_fn(c);
+  NeuroRectangle *const r = client->free_setter_fn != NeuroRuleFreeSetterNull ? NeuroCoreClientGetRegion(c) :
+      NeuroCoreClientGetFloatRegion(c);
+  if (ev->value_mask & CWX)
+    r->p.x = ev->x - l->border_gap_setter_fn(c);
+  if (ev->value_mask & CWY)
+    r->p.y = ev->y - l->border_gap_setter_fn(c);
+  if (ev->value_mask & CWWidth)
+    r->w = ev->width + border*2;
+  if (ev->value_mask & CWHeight)
+    r->h = ev->height + border*2;
+}
+
+// The window is mapped, arranged and focused when the pending work is flushed
+static void manage_window(Window w, const NeuroSystemWindowProperties *wp) {
+  assert(wp);
+
+  // Check if window is valid
+  if (wp->attributes.override_redirect)
     return;
 
+  // Add client to the stack list
+  NeuroClient *const cli = NeuroRuleNewClient(w, wp);
+  if (!cli)
+    NeuroSystemError(__func__, "Could not alloc NeuroClient and set rules");
+  NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  if (!c)
+    NeuroSystemError(__func__, "Could not add client");
+
+  // Transient windows
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  if (wp->is_transient) {
+    NeuroCoreClientSetFreeSetter(c, NeuroRuleFreeSetterFit);
+    NeuroClientPtrPtr t = NeuroClientFindWindow(wp->transient_for);
+    if (t)
+      NeuroGeometryRectangleCenter(NeuroCoreClientGetRegion(c), NeuroCoreClientGetRegion(t));
+    else
+      NeuroGeometryRectangleCenter(NeuroCoreClientGetRegion(c), NeuroCoreStackGetRegion(client->ws));
+  }
+
+  // Map it once the workspace is arranged
+  const bool is_mapped = wp->attributes.map_state == IsViewable;
+  XSelectInput(NeuroSystemGetDisplay(), client->win, NEURO_SYSTEM_CLIENT_MASK);
+  NeuroClientSetMapped(c, &is_mapped);
+  NeuroClientGrabButtons(c, NULL);
+  NeuroClientUpdateSyncCounter(c, NULL);
+  set_pending(client->ws, EVENT_PENDING_LAYOUT | EVENT_PENDING_FOCUS);
+}
+
+static void unmanage_client(NeuroClientPtrPtr c) {
+  assert(c);
+  const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
+  NeuroClient *cli = NeuroCoreRemoveClient(c);
+  NeuroTypeDeleteClient(cli);
+  set_pending(ws, EVENT_PENDING_LAYOUT | EVENT_PENDING_FOCUS);
+}
+
+// Key and button events carry the pointer location, so the actions do not need to ask the X server for it
+static void set_action_context(NeuroActionContext *ctx, Window w, Window subw, int x_root, int y_root, Time time) {
+  assert(ctx);
+  ctx->pointer.x = x_root;
+  ctx->pointer.y = y_root;
+  ctx->window = w != NeuroSystemGetRoot() ? w : subw;
+  ctx->time = time;
+}
+
+static void do_key_press(XEvent *e) {
+  assert(e);
+  const XKeyEvent *const ev = &e->xkey;
+  NeuroActionContext ctx;
+  set_action_context(&ctx, ev->window, ev->subwindow, ev->x_root, ev->y_root, ev->time);
+  NeuroIndex it = 0U;
+  for (const NeuroKey *k; (k = NeuroSystemGetKeyBinding(ev->keycode, ev->state, &it)); ) {
+    NeuroActionRunActionChain(&k->action_chain, &ctx);
+    pending_info_.is_panel_dirty = true;
+  }
+}
+
+static void do_button_press(XEvent *e) {
+  assert(e);
+  if (NeuroClientIsDragging())
+    return;
   const XButtonPressedEvent *const ev = &e->xbutton;
-  for (NeuroIndex i = 0U; button_list[ i ]; ++i) {
-    const NeuroButton *b = button_list[ i ];
-    if (b->button == ev->button && b->mod == ev->state) {
-      NeuroActionRunActionChain(&b->action_chain);
-      NeuroDzenRefresh(true);
-    }
+  NeuroActionContext ctx;
+  set_action_context(&ctx, ev->window, ev->subwindow, ev->x_root, ev->y_root, ev->time);
+  NeuroIndex it = 0U;
+  for (const NeuroButton *b; (b = NeuroSystemGetButtonBinding(ev->button, ev->state, &it)); ) {
+    NeuroActionRunActionChain(&b->action_chain, &ctx);
+    pending_info_.is_panel_dirty = true;
+  }
+}
+
+static void do_button_release(XEvent *e) {
+  assert(e);
+  if (!NeuroClientIsDragging())
+    return;
+  NeuroClientStopDrag();
+  NeuroSystemIgnoreEnterNotify();
+  pending_info_.is_panel_dirty = true;
+}
+
+static void do_motion_notify(XEvent *e) {
+  assert(e);
+  const XMotionEvent *const ev = &e->xmotion;
+  NeuroClientDragMotion(ev->x_root, ev->y_root, ev->time);
+}
+
+static void do_mapping_notify(XEvent *e) {
+  assert(e);
+  XMappingEvent *const ev = &e->xmapping;
+  XRefreshKeyboardMapping(ev);
+  if (ev->request != MappingKeyboard && ev->request != MappingModifier)
+    return;
+  if (!NeuroSystemUpdateBindings())
+    NeuroSystemError(__func__, "Could not update bindings");
+
+  // The lock masks may have changed, so the buttons are grabbed again on the next focus change, minimized clients too
+  for (NeuroIndex i = 0U; i < NeuroCoreGetSize(); ++i) {
+    for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(i); c; c = NeuroCoreClientGetNext(c))
+      NeuroClientInvalidateButtons(c, NULL);
+    for (NeuroClientPtrPtr c = NeuroCoreStackGetMinimizedHeadClient(i); c; c = NeuroCoreClientGetNext(c))
+      NeuroClientInvalidateButtons(c, NULL);
   }
 }
 
 static void do_map_request(XEvent *e) {
   assert(e);
-  NeuroEventManageWindow(e->xmaprequest.window);
-  NeuroDzenRefresh(true);
+  const Window w = e->xmaprequest.window;
+  if (NeuroClientFindWindow(w))
+    return;
+  NeuroSystemWindowProperties wp;
+  if (!NeuroSystemFetchWindowProperties(&wp, w))
+    return;
+  manage_window(w, &wp);
+  NeuroSystemFreeWindowProperties(&wp);
+  pending_info_.is_panel_dirty = true;
 }
 
 static void do_destroy_notify(XEvent *e) {
@@ -76,30 +307,37 @@ static void do_destroy_notify(XEvent *e) {
   const Window w = e->xdestroywindow.window;
   NeuroClientPtrPtr c = NeuroClientFindWindow(w);
   if (c) {
-    NeuroEventUnmanageClient(c);
+    unmanage_client(c);
   } else {
     NeuroClient *cli = NeuroCoreRemoveMinimizedClient(w);
     NeuroTypeDeleteClient(cli);
   }
-  NeuroDzenRefresh(true);
+  pending_info_.is_panel_dirty = true;
 }
 
+// Each unmap is reported to the root and to the window, only the one reported to the root is handled
 static void do_unmap_notify(XEvent *e) {
   assert(e);
-  const Window w = e->xdestroywindow.window;
-  NeuroClientPtrPtr c = NeuroClientFindWindow(w);
+  const XUnmapEvent *const ev = &e->xunmap;
+  if (ev->event != NeuroSystemGetRoot())
+    return;
+  NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
+  if (c && !ev->send_event && NeuroClientIsUnmapIgnored(c))  // Hidden by neurowm, not withdrawn
+    return;
   if (c) {
-    NeuroEventUnmanageClient(c);
+    unmanage_client(c);
   } else {
-    NeuroClient *cli = NeuroCoreRemoveMinimizedClient(w);
+    NeuroClient *cli = NeuroCoreRemoveMinimizedClient(ev->window);
     NeuroTypeDeleteClient(cli);
   }
-  NeuroDzenRefresh(true);
+  pending_info_.is_panel_dirty = true;
 }
 
 static void do_enter_notify(XEvent *e) {
   assert(e);
   const XCrossingEvent *const ev = &e->xcrossing;
+  if (NeuroSystemIsEnterNotifyIgnored(ev->serial))
+    return;
   if ((ev->mode != NotifyNormal || ev->detail == NotifyInferior) && ev->window != NeuroSystemGetRoot())
     return;
   NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
@@ -116,20 +354,28 @@ static void do_enter_notify(XEvent *e) {
     return;
 
   // Do not focus if there is a fullscreen client in the stack
-  if (NeuroCoreStackFindClient(client->ws, NeuroClientTesterFullscreen, NULL))
+  if (NeuroCoreStackGetFlagNum(client->ws, NEURO_CLIENT_FLAG_FULLSCREEN) > 0U)
     return;
 
   // Focus the client
   NeuroWorkspaceUnfocus(NeuroCoreGetCurrStack());
   NeuroCoreSetCurrStack(client->ws);
   NeuroWorkspaceClientFocus(c, NeuroClientSelectorSelf, NULL);
-  NeuroDzenRefresh(true);
+  pending_info_.is_panel_dirty = true;
 }
 
 static void do_configure_request(XEvent *e) {
   assert(e);
   const XConfigureRequestEvent *const ev = &e->xconfigurerequest;
+  NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
+
+  // Tiled and fullscreen clients keep the geometry set by the layout
+  if (c && !is_configurable_client(c)) {
+    NeuroClientDenyConfigureRequest(c, NULL);
+    return;
+  }
 
+  // Unmanaged windows are configured as they asked
   XWindowChanges wc;
   wc.x = ev->x;
   wc.y = ev->y;
@@ -138,14 +384,23 @@ static void do_configure_request(XEvent *e) {
   wc.sibling = ev->above;
   wc.stack_mode = ev->detail;
   wc.border_width = ev->border_width;
-  XConfigureWindow(NeuroSystemGetDisplay(), ev->window, ev->value_mask, &wc);
-  NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
-  if (c) {
-    const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
-    NeuroLayoutRunCurr(ws);
-    NeuroWorkspaceUpdate(ws);
+  if (!c) {
+    XConfigureWindow(NeuroSystemGetDisplay(), ev->window, ev->value_mask, &wc);
+    return;
+  }
+
+  // Only the stacking is forwarded, the geometry is stored and sent once when the pending layout is flushed
+  const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
+  if (ev->value_mask & (CWSibling|CWStackMode)) {
+    XConfigureWindow(NeuroSystemGetDisplay(), ev->window, ev->value_mask & (CWSibling|CWStackMode), &wc);
+    NeuroCoreStackSetStackingDirty(ws, true);
   }
-  NeuroDzenRefresh(true);
+  if ((ev->value_mask & (CWX|CWY)) && NEURO_CLIENT_PTR(c)->free_setter_fn != NeuroRuleFreeSetterNull)
+    NeuroCoreClientSetFreeSetter(c, NeuroRuleFreeSetterFit);  // Other free setters would move it elsewhere
+  set_requested_region(c, ev);
+  NeuroClientInvalidateRegion(c, NULL);  // Even an unchanged geometry must be answered with a ConfigureNotify
+  set_pending(ws, EVENT_PENDING_LAYOUT);
+  pending_info_.is_panel_dirty = true;
 }
 
 static void do_focus_in(XEvent *e) {
@@ -157,7 +412,7 @@ static void do_focus_in(XEvent *e) {
     return;
 
   NeuroWorkspaceClientFocus(c, NeuroClientSelectorSelf, NULL);
-  NeuroDzenRefresh(true);
+  pending_info_.is_panel_dirty = true;
 }
 
 static void do_client_message(XEvent *e) {
@@ -178,7 +433,7 @@ static void do_client_message(XEvent *e) {
   } else if (e->xclient.message_type == NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_ACTIVE)) {
     NeuroWorkspaceClientFocus(c, NeuroClientSelectorSelf, NULL);
   }
-  NeuroDzenRefresh(true);
+  pending_info_.is_panel_dirty = true;
 }
 
 static void do_property_notify(XEvent *e) {
@@ -194,6 +449,35 @@ static void do_property_notify(XEvent *e) {
     NeuroClientUpdateTitle(c, NULL);
   }
 
+  // Update size hints, the layout applies them
+  if (ev->atom == XA_WM_NORMAL_HINTS) {
+    NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
+    if (!c)
+      return;
+
+    NeuroClientUpdateSizeHints(c, NULL);
+    set_pending(NEURO_CLIENT_PTR(c)->ws, EVENT_PENDING_LAYOUT);
+  }
+
+  // Update the counter used to pace interactive resizes
+  if (ev->atom == NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_SYNCREQUESTCOUNTER) ||
+      ev->atom == NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_PROTOCOLS)) {
+    NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
+    if (!c)
+      return;
+
+    NeuroClientUpdateSyncCounter(c, NULL);
+  }
+
+  // Update the _NET_WM_STATE atoms neurowm keeps, its own changes are already known
+  if (ev->atom == NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_STATE)) {
+    NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
+    if (!c || NeuroClientIsNetStateNotifyIgnored(c, ev->serial))
+      return;
+
+    NeuroClientUpdateNetStates(c, NULL);
+  }
+
   // Update urgency hint
   if (ev->atom == XA_WM_HINTS) {
     NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
@@ -214,8 +498,17 @@ static void do_property_notify(XEvent *e) {
     NeuroClientUpdate(c, NULL);
   }
 
-  NeuroDzenRefresh(true);
+  pending_info_.is_panel_dirty = true;
+}
+
+#ifdef XSYNC
+// The dragged client redrew after the last sync request, so it can be resized again
+static void do_sync_alarm_notify(XEvent *e) {
+  assert(e);
+  const XSyncAlarmNotifyEvent *const ev = (const XSyncAlarmNotifyEvent *)(void *)e;
+  NeuroClientDragSyncNotify(ev->alarm, ev->time);
 }
+#endif
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -225,6 +518,8 @@ static void do_property_notify(XEvent *e) {
 static const NeuroEventHandlerFn event_handlers_[ LASTEvent ] = {
   [ KeyPress ] = do_key_press,
   [ ButtonPress ] = do_button_press,
+  [ ButtonRelease ] = do_button_release,
+  [ MotionNotify ] = do_motion_notify,
   [ MapRequest ] = do_map_request,
   [ UnmapNotify ] = do_unmap_notify,
   [ DestroyNotify ] = do_destroy_notify,
@@ -232,7 +527,8 @@ static const NeuroEventHandlerFn event_handlers_[ LASTEvent ] = {
   [ ConfigureRequest ] = do_configure_request,
   [ FocusIn ] = do_focus_in,
   [ ClientMessage ] = do_client_message,
-  [ PropertyNotify ] = do_property_notify
+  [ PropertyNotify ] = do_property_notify,
+  [ MappingNotify ] = do_mapping_notify
 };
 
 
@@ -240,63 +536,61 @@ static const NeuroEventHandlerFn event_handlers_[ LASTEvent ] = {
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Init and Stop
+// NOTE: it must be called after NeuroCoreInit, which sets the number of workspaces
+bool NeuroEventInit(void) {
+  pending_info_.num_stacks = NeuroCoreGetSize();
+  pending_info_.stacks = (unsigned int *)calloc(pending_info_.num_stacks, sizeof(unsigned int));
+  return pending_info_.stacks != NULL;
+}
+
+void NeuroEventStop(void) {
+  free(pending_info_.stacks);
+  pending_info_.stacks = NULL;
+  pending_info_.num_stacks = 0U;
+  pending_info_.is_panel_dirty = false;
+}
+
+// Extension events are numbered from their event base, after the core events
 NeuroEventHandlerFn NeuroEventGetHandler(NeuroEventType t) {
+#ifdef XSYNC
+  const int sync_base = NeuroSystemGetSyncEventBase();
+  if (sync_base >= 0 && t == (NeuroEventType)(sync_base + XSyncAlarmNotify))
+    return do_sync_alarm_notify;
+#endif
+  if (t >= LASTEvent)
+    return NULL;
   return event_handlers_[ t ];
 }
 
-void NeuroEventManageWindow(Window w) {
-  // Check if window is valid
-  XWindowAttributes wa;
-  if (!XGetWindowAttributes(NeuroSystemGetDisplay(), w, &wa))
-    return;
-  if (wa.override_redirect)
+// Handles a batch of events read at once, coalescing them and running layouts, focus and panels once at the end
+void NeuroEventHandleBatch(XEvent *events, NeuroIndex n) {
+  if (!events)
     return;
-  if (NeuroClientFindWindow(w))
-    return;
-
-  // Add client to the stack list
-  NeuroClient *const cli = NeuroRuleNewClient(w, &wa);
-  if (!cli)
-    NeuroSystemError(__func__, "Could not alloc NeuroClient and set rules");
-  NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
-  if (!c)
-    NeuroSystemError(__func__, "Could not add client");
-
-  // Transient windows
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
-  Window trans = None;
-  if (XGetTransientForHint(NeuroSystemGetDisplay(), client->win, &trans)) {
-    client->free_setter_fn = NeuroRuleFreeSetterFit;
-    NeuroClientPtrPtr t = NeuroClientFindWindow(trans);
-    if (t)
-      NeuroGeometryRectangleCenter(NeuroCoreClientGetRegion(c), NeuroCoreClientGetRegion(t));
-    else
-      NeuroGeometryRectangleCenter(NeuroCoreClientGetRegion(c), NeuroCoreStackGetRegion(client->ws));
+  coalesce_events(events, n);
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    const NeuroEventHandlerFn eh = NeuroEventGetHandler(events[ i ].type);
+    if (eh)
+      eh(events + i);
   }
+  flush_pending();
+}
 
-  // Run layout and update ws focus
-  NeuroWorkspaceRemoveEnterNotifyMask(client->ws);
-
-  NeuroLayoutRunCurr(client->ws);
-  XSelectInput(NeuroSystemGetDisplay(), client->win, NEURO_SYSTEM_CLIENT_MASK);
-  NeuroSystemGrabButtons(client->win, NeuroConfigGet()->button_list);
-  XMapWindow(NeuroSystemGetDisplay(), client->win);
-  NeuroWorkspaceUpdate(client->ws);
-  NeuroWorkspaceFocus(client->ws);
-
-  NeuroWorkspaceAddEnterNotifyMask(client->ws);
+void NeuroEventManageWindow(Window w) {
+  if (NeuroClientFindWindow(w))
+    return;
+  NeuroSystemWindowProperties wp;
+  if (!NeuroSystemFetchWindowProperties(&wp, w))
+    return;
+  manage_window(w, &wp);
+  NeuroSystemFreeWindowProperties(&wp);
+  flush_pending();
 }
 
 void NeuroEventUnmanageClient(NeuroClientPtrPtr c) {
   assert(c);
-  const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
-  NeuroClient *cli = NeuroCoreRemoveClient(c);
-  NeuroTypeDeleteClient(cli);
-  NeuroLayoutRunCurr(ws);
-  NeuroWorkspaceUpdate(ws);
-  NeuroWorkspaceFocus(ws);
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  unmanage_client(c);
+  flush_pending();
 }
 
 void NeuroEventLoadWindows(void) {
@@ -308,17 +602,31 @@ void NeuroEventLoadWindows(void) {
 
   // Manage the windows
   for (unsigned int i = 0; i < num; ++i) {
-    XWindowAttributes wa;
-    if (!XGetWindowAttributes(NeuroSystemGetDisplay(), wins[ i ], &wa))
-      continue;
-
-    if (wa.map_state != IsViewable)
+    NeuroSystemWindowProperties wp;
+    if (!NeuroSystemFetchWindowProperties(&wp, wins[ i ]))
       continue;
 
-    NeuroEventManageWindow(wins[ i ]);
+    if (wp.attributes.map_state == IsViewable && !NeuroClientFindWindow(wins[ i ]))
+      manage_window(wins[ i ], &wp);
+    NeuroSystemFreeWindowProperties(&wp);
   }
+  flush_pending();
 
   if (wins)
     XFree(wins);
 }
 
+// Maps the clients of hidden workspaces back off screen, only viewable windows are loaded by the next window manager
+void NeuroEventUnloadWindows(void) {
+  const NeuroPoint *const hidden = &NeuroSystemGetHiddenRegion()->p;
+  for (NeuroIndex ws = 0U; ws < NeuroCoreGetSize(); ++ws) {
+    if (NeuroCoreStackGetMonitor(ws))
+      continue;
+    for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c)) {
+      XMoveWindow(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win, hidden->x, hidden->y);
+      XMapWindow(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win);
+    }
+  }
+  XSync(NeuroSystemGetDisplay(), false);
+}
+
@@ -32,8 +32,12 @@ typedef unsigned int NeuroEventType;
 // VARIABLE DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
 
+bool NeuroEventInit(void);
+void NeuroEventStop(void);
 NeuroEventHandlerFn NeuroEventGetHandler(NeuroEventType t);
+void NeuroEventHandleBatch(XEvent *events, NeuroIndex n);
 void NeuroEventManageWindow(Window w);
 void NeuroEventUnmanageClient(NeuroClientPtrPtr c);
 void NeuroEventLoadWindows(void);
+void NeuroEventUnloadWindows(void);
 
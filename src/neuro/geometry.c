@@ -170,6 +170,84 @@ NeuroRectangle *NeuroGeometryRectangleCenter(NeuroRectangle *r, const NeuroRecta
   return r;
 }
 
+// Shrinks the size to the closest one allowed by the size hints, keeping the top left point (ICCCM 4.1.2.3)
+NeuroRectangle *NeuroGeometryRectangleSetSizeHints(NeuroRectangle *r, const NeuroSizeHints *sh) {
+  assert(r);
+  assert(sh);
+  const bool is_base_min = sh->base_w == sh->min_w && sh->base_h == sh->min_h;
+  int w = r->w, h = r->h;
+
+  // The base size is not part of the aspect ratio, unless it is the minimum size too
+  if (!is_base_min) {
+    w -= sh->base_w;
+    h -= sh->base_h;
+  }
+  if (sh->min_aspect > 0.0f && sh->max_aspect > 0.0f && w > 0 && h > 0) {
+    if (sh->max_aspect < (float)w / (float)h)
+      w = (int)((float)h * sh->max_aspect + 0.5f);
+    else if (sh->min_aspect < (float)h / (float)w)
+      h = (int)((float)w * sh->min_aspect + 0.5f);
+  }
+  if (is_base_min) {
+    w -= sh->base_w;
+    h -= sh->base_h;
+  }
+
+  // Increments, then minimum and maximum sizes
+  if (sh->inc_w > 0)
+    w -= w % sh->inc_w;
+  if (sh->inc_h > 0)
+    h -= h % sh->inc_h;
+  w += sh->base_w;
+  h += sh->base_h;
+  if (w < sh->min_w)
+    w = sh->min_w;
+  if (h < sh->min_h)
+    h = sh->min_h;
+  if (sh->max_w > 0 && w > sh->max_w)
+    w = sh->max_w;
+  if (sh->max_h > 0 && h > sh->max_h)
+    h = sh->max_h;
+
+  // Never grow the window out of the given region
+  if (w < r->w)
+    r->w = w;
+  if (h < r->h)
+    r->h = h;
+  return r;
+}
+
+// Rectangle Array Modifiers (they work on contiguous arrays so that the loops can be vectorized)
+NeuroRectangle *NeuroGeometryRectanglesReflectX(NeuroRectangle *rs, NeuroIndex n, const NeuroRectangle *reg) {
+  assert(rs || n == 0U);
+  assert(reg);
+  const int k = 2 * (reg->p.x) + reg->w;
+  for (NeuroIndex i = 0U; i < n; ++i)
+    rs[ i ].p.x = k - (rs[ i ].p.x + rs[ i ].w);
+  return rs;
+}
+
+NeuroRectangle *NeuroGeometryRectanglesReflectY(NeuroRectangle *rs, NeuroIndex n, const NeuroRectangle *reg) {
+  assert(rs || n == 0U);
+  assert(reg);
+  const int k = 2 * (reg->p.y) + reg->h;
+  for (NeuroIndex i = 0U; i < n; ++i)
+    rs[ i ].p.y = k - (rs[ i ].p.y + rs[ i ].h);
+  return rs;
+}
+
+NeuroRectangle *NeuroGeometryRectanglesTranspose(NeuroRectangle *rs, NeuroIndex n) {
+  assert(rs || n == 0U);
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    const NeuroRectangle r = rs[ i ];
+    rs[ i ].p.x = r.p.y;
+    rs[ i ].p.y = r.p.x;
+    rs[ i ].w = r.h;
+    rs[ i ].h = r.w;
+  }
+  return rs;
+}
+
 // Point-Rectangle Testers
 bool NeuroGeometryIsPointInRectangle(const NeuroRectangle *r, const NeuroPoint *p) {
   assert(r);
@@ -185,3 +263,10 @@ bool NeuroGeometryIsPointInRectangle(const NeuroRectangle *r, const NeuroPoint *
   return true;
 }
 
+// Rectangle Testers
+bool NeuroGeometryRectangleIsEqual(const NeuroRectangle *r1, const NeuroRectangle *r2) {
+  assert(r1);
+  assert(r2);
+  return r1->p.x == r2->p.x && r1->p.y == r2->p.y && r1->w == r2->w && r1->h == r2->h;
+}
+
@@ -42,7 +42,16 @@ NeuroRectangle *NeuroGeometryRectangleReflectY(NeuroRectangle *r, const NeuroRec
 NeuroRectangle *NeuroGeometryRectangleTranspose(NeuroRectangle *r);
 NeuroRectangle *NeuroGeometryRectangleFit(NeuroRectangle *r, const NeuroRectangle *reg);
 NeuroRectangle *NeuroGeometryRectangleCenter(NeuroRectangle *r, const NeuroRectangle *reg);
+NeuroRectangle *NeuroGeometryRectangleSetSizeHints(NeuroRectangle *r, const NeuroSizeHints *sh);
+
+// Rectangle Array Modifiers
+NeuroRectangle *NeuroGeometryRectanglesReflectX(NeuroRectangle *rs, NeuroIndex n, const NeuroRectangle *reg);
+NeuroRectangle *NeuroGeometryRectanglesReflectY(NeuroRectangle *rs, NeuroIndex n, const NeuroRectangle *reg);
+NeuroRectangle *NeuroGeometryRectanglesTranspose(NeuroRectangle *rs, NeuroIndex n);
 
 // Point-Rectangle Testers
 bool NeuroGeometryIsPointInRectangle(const NeuroRectangle *r, const NeuroPoint *p);
 
+// Rectangle Testers
+bool NeuroGeometryRectangleIsEqual(const NeuroRectangle *r1, const NeuroRectangle *r2);
+
@@ -19,74 +19,44 @@
 #include "workspace.h"
 #include "rule.h"
 
-// Defines
-#define STEP_SIZE_REALLOC 32
-
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-static NeuroArrange *new_arrange(NeuroIndex ws, NeuroLayout *l) {
+static bool is_above_tiled_client(const NeuroClientPtrPtr c) {
+  assert(c);
+  return NEURO_CLIENT_PTR(c)->free_setter_fn != NeuroRuleFreeSetterNull || NEURO_CLIENT_PTR(c)->is_fullscreen;
+}
+
+static bool is_tiled_client(const NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  return !is_above_tiled_client(c) && NEURO_CLIENT_PTR(c)->fixed_pos == NEURO_FIXED_POSITION_NULL;
+}
+
+// Returns the arrange of the stack, it is owned by the stack so running a layout does not allocate
+static NeuroArrange *get_arrange(NeuroIndex ws, NeuroLayout *l) {
   if (!l)
     return NULL;
 
-  // Allocate a new arrange
-  NeuroArrange *const a = (NeuroArrange *)malloc(sizeof(NeuroArrange));
+  // Gather the regions of the tiled clients, the arrange is a view over them
+  NeuroArrange *const a = NeuroCoreStackGatherRegions(ws, is_tiled_client);
   if (!a)
     return NULL;
 
   // Set the region
   NeuroGeometryRectangleGetRelative(&a->region, NeuroCoreStackGetRegion(ws), l->region);
 
-  // Set the clients
-  NeuroRectangle **rs = NULL, **frs = NULL;
-  NeuroIndex i = 0U, size = 0U;
-  for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c)) {
-    // Skip free and fullscreen clients
-    if (NEURO_CLIENT_PTR(c)->free_setter_fn != NeuroRuleFreeSetterNull || NEURO_CLIENT_PTR(c)->is_fullscreen)
-      continue;
-
-    // Update region if there are fixed clients
-    if (NEURO_CLIENT_PTR(c)->fixed_pos != NEURO_FIXED_POSITION_NULL) {
-      NeuroRuleSetLayoutRegion(&a->region, c);
-      continue;
-    }
-
-    // Realloc if memory is needed
-    if (i >= size || i <= 0) {
-      size += STEP_SIZE_REALLOC;
-      rs = (NeuroRectangle **)realloc(rs, size*sizeof(void *));
-      frs = (NeuroRectangle **)realloc(frs, size*sizeof(void *));
-      if (!rs || !frs)
-        return NULL;
-    }
-
-    // Set rs and frs arrays
-    rs[ i ] = NeuroCoreClientGetRegion(c);
-    frs[ i ] = &(NEURO_CLIENT_PTR(c)->float_region);
-    ++i;
-  }
+  // Update region if there are fixed clients
+  if (NeuroCoreStackGetFlagNum(ws, NEURO_CLIENT_FLAG_FIXED) > 0U)
+    for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
+      if (!is_above_tiled_client(c) && NEURO_CLIENT_PTR(c)->fixed_pos != NEURO_FIXED_POSITION_NULL)
+        NeuroRuleSetLayoutRegion(&a->region, c);
 
-  // Complete the arrange
-  a->size = i;
-  a->client_regions = rs;
-  a->client_float_regions = frs;
   a->parameters = l->parameters;
   return a;
 }
 
-static void delete_arrange(NeuroArrange *a) {
-  if (!a)
-    return;
-  free(a->client_regions);
-  a->client_regions = NULL;
-  free(a->client_float_regions);
-  a->client_float_regions = NULL;
-  free(a);
-  a = NULL;
-}
-
 static void get_best_positions_and_sizes(NeuroIndex n, int total, int *positions, int *sizes) {
   assert(positions);
   assert(sizes);
@@ -114,8 +84,7 @@ static NeuroArrange *mirror_arrange(NeuroArrange *a, NeuroArrangerFn af) {
   assert(af);
   NeuroGeometryRectangleTranspose(&a->region);
   af(a);
-  for (NeuroIndex i = 0U; i < a->size; ++i)
-    NeuroGeometryRectangleTranspose(a->client_regions[ i ]);
+  NeuroGeometryRectanglesTranspose(a->client_regions, a->size);
   NeuroGeometryRectangleTranspose(&a->region);
   return a;
 }
@@ -123,15 +92,13 @@ static NeuroArrange *mirror_arrange(NeuroArrange *a, NeuroArrangerFn af) {
 // Mods
 static NeuroArrange *reflect_x_mod(NeuroArrange *a) {
   assert(a);
-  for (NeuroIndex i = 0U; i < a->size; ++i)
-    NeuroGeometryRectangleReflectX(a->client_regions[ i ], &a->region);
+  NeuroGeometryRectanglesReflectX(a->client_regions, a->size, &a->region);
   return a;
 }
 
 static NeuroArrange *reflect_y_mod(NeuroArrange *a) {
   assert(a);
-  for (NeuroIndex i = 0U; i < a->size; ++i)
-    NeuroGeometryRectangleReflectY(a->client_regions[ i ], &a->region);
+  NeuroGeometryRectanglesReflectY(a->client_regions, a->size, &a->region);
   return a;
 }
 
@@ -140,9 +107,14 @@ static NeuroArrange *reflect_y_mod(NeuroArrange *a) {
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Stacks without monitor are not visible, so they are arranged once they get one (NeuroWorkspaceChange)
 void NeuroLayoutRun(NeuroIndex ws, NeuroIndex i) {
+  if (!NeuroCoreStackGetMonitor(ws)) {
+    NeuroCoreStackSetLayoutDirty(ws, true);
+    return;
+  }
   NeuroLayout *const l = NeuroCoreStackGetLayout(ws, i);
-  NeuroArrange *const a = new_arrange(ws, l);
+  NeuroArrange *const a = get_arrange(ws, l);
   if (!a)
     NeuroSystemError(__func__, "Could not run layout");
   if (a->size) {  // Then run layout
@@ -155,7 +127,8 @@ void NeuroLayoutRun(NeuroIndex ws, NeuroIndex i) {
     if (l->mod & NEURO_LAYOUT_MOD_REFLECTY)
       reflect_y_mod(a);
   }
-  delete_arrange(a);
+  NeuroCoreStackInvalidateRegions(ws);  // The arrangers wrote the regions in place
+  NeuroCoreStackSetLayoutDirty(ws, false);
 }
 
 void NeuroLayoutRunCurr(NeuroIndex ws) {
@@ -236,7 +209,7 @@ NeuroArrange *NeuroLayoutArrangerTall(NeuroArrange *a) {
   get_best_positions_and_sizes(nwindows, a->region.h, ys, hs);
   NeuroIndex i = 0U;
   for ( ; i < nwindows; ++i) {
-    NeuroRectangle *const r = a->client_regions[ i ];
+    NeuroRectangle *const r = a->client_regions + i;
     r->p.x = a->region.p.x;
     r->p.y = a->region.p.y + ys[ i ];
     r->w = n > mn ? ms : a->region.w;
@@ -250,7 +223,7 @@ NeuroArrange *NeuroLayoutArrangerTall(NeuroArrange *a) {
   // Stacking area
   get_best_positions_and_sizes(n - nwindows, a->region.h, ys, hs);
   for ( ; i < n; ++i) {
-    NeuroRectangle *const r = a->client_regions[ i ];
+    NeuroRectangle *const r = a->client_regions + i;
     r->p.x = a->region.p.x + ms;
     r->p.y = a->region.p.y + ys[ i-nwindows ];
     r->w = a->region.w - ms;
@@ -285,7 +258,7 @@ NeuroArrange *NeuroLayoutArrangerGrid(NeuroArrange *a) {
     get_best_positions_and_sizes(rows, a->region.h, ys, hs);
 
     // Update client region
-    NeuroRectangle *const r = a->client_regions[ i ];
+    NeuroRectangle *const r = a->client_regions + i;
     r->p.x = a->region.p.x + xs[ cn ];
     r->p.y = a->region.p.y + ys[ rn ];
     r->w = ws[ cn ];
@@ -302,7 +275,7 @@ NeuroArrange *NeuroLayoutArrangerGrid(NeuroArrange *a) {
 NeuroArrange *NeuroLayoutArrangerFull(NeuroArrange *a) {
   assert(a);
   for (NeuroIndex i = 0U; i < a->size; ++i) {
-    NeuroRectangle *const r = a->client_regions[ i ];
+    NeuroRectangle *const r = a->client_regions + i;
     memmove(r, &a->region, sizeof(NeuroRectangle));
   }
   return a;
@@ -311,10 +284,9 @@ NeuroArrange *NeuroLayoutArrangerFull(NeuroArrange *a) {
 NeuroArrange *NeuroLayoutArrangerFloat(NeuroArrange *a) {
   assert(a);
   for (NeuroIndex i = 0U; i < a->size; ++i) {
-    const NeuroRectangle *const fr = a->client_float_regions[ i ];
-    NeuroRectangle *const r = a->client_regions[ i ];
-    memmove(r, fr, sizeof(NeuroRectangle));
-    NeuroGeometryRectangleFit(a->client_regions[ i ], &a->region);
+    NeuroRectangle *const r = a->client_regions + i;
+    memmove(r, a->client_float_regions + i, sizeof(NeuroRectangle));
+    NeuroGeometryRectangleFit(r, &a->region);
   }
   return a;
 }
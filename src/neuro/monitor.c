@@ -37,6 +37,34 @@ struct MonitorSet {
 static MonitorSet monitor_set_;
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE FUNCTION DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+#ifdef XRANDR
+
+static int get_refresh_rate(const XRRScreenResources *sr, RRMode mode) {
+  assert(sr);
+  for (int i = 0; i < sr->nmode; ++i) {
+    const XRRModeInfo *const mi = sr->modes + i;
+    if (mi->id != mode)
+      continue;
+    double v_total = mi->vTotal;
+    if (mi->modeFlags & RR_DoubleScan)
+      v_total *= 2.0;
+    if (mi->modeFlags & RR_Interlace)
+      v_total /= 2.0;
+    if (!mi->hTotal || v_total <= 0.0)
+      break;
+    const int rate = (int)((double)mi->dotClock / ((double)mi->hTotal * v_total) + 0.5);
+    return rate > 0 ? rate : NEURO_MONITOR_DEFAULT_REFRESH_RATE;
+  }
+  return NEURO_MONITOR_DEFAULT_REFRESH_RATE;
+}
+
+#endif
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
@@ -87,6 +115,7 @@ bool NeuroMonitorInit(void) {
     m->dzen_panel_list = mc->dzen_panel_list;
     const NeuroRectangle screen_region = { (NeuroPoint){ screen->x, screen->y }, screen->width, screen->height };
     NeuroGeometryRectangleGetReduced((NeuroRectangle *)&m->region, &screen_region, mc->gaps);
+    m->refresh_rate = get_refresh_rate(screen_list, screen->mode);
 
     // Increment monitor iterator
     ++monitor_iterator;
@@ -113,6 +142,7 @@ bool NeuroMonitorInit(void) {
   m->dzen_panel_list = mc->dzen_panel_list;
   const NeuroRectangle screen_region = { (NeuroPoint){ screen->p.x, screen->p.y }, screen->w, screen->h };
   NeuroGeometryRectangleGetReduced((NeuroRectangle *)&m->region, &screen_region, mc->gaps);
+  m->refresh_rate = NEURO_MONITOR_DEFAULT_REFRESH_RATE;
 
 #endif
 
@@ -16,6 +16,9 @@
 // Includes
 #include "type.h"
 
+// Defines
+#define NEURO_MONITOR_DEFAULT_REFRESH_RATE 60
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // FUNCTION DECLARATION
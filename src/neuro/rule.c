@@ -21,45 +21,63 @@
 #include "workspace.h"
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// RuleStrings (interned class and name of a rule)
+struct RuleStrings {
+  const char *class;
+  const char *name;
+};
+typedef struct RuleStrings RuleStrings;
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Interned strings of each rule in the rule list, in the same order
+static RuleStrings *rule_strings_ = NULL;
+static const char *scratchpad_name_ = NULL;
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-static bool is_free_size_hints(NeuroClient *c) {
-  assert(c);
+static bool is_free_size_hints(const XSizeHints *size) {
+  assert(size);
   int maxw = 0, maxh = 0, minw = 0, minh = 0;
-  long msize = 0L;
-  XSizeHints size;
-  if (!XGetWMNormalHints(NeuroSystemGetDisplay(), c->win, &size, &msize))
-    size.flags = PSize;
-  if (size.flags & PMaxSize) {
-    maxw = size.max_width;
-    maxh = size.max_height;
+  if (size->flags & PMaxSize) {
+    maxw = size->max_width;
+    maxh = size->max_height;
   }
-  if (size.flags & PMinSize) {
-    minw = size.min_width;
-    minh = size.min_height;
-  } else if (size.flags & PBaseSize) {
-    minw = size.base_width;
-    minh = size.base_height;
+  if (size->flags & PMinSize) {
+    minw = size->min_width;
+    minh = size->min_height;
+  } else if (size->flags & PBaseSize) {
+    minw = size->base_width;
+    minh = size->base_height;
   }
   return maxw && minw && maxh && minh && maxw == minw && maxh == minh;
 }
 
-static bool has_rule(const NeuroClient *c, const NeuroRule *r) {
+static bool has_rule(const NeuroClient *c, const NeuroRule *r, const RuleStrings *rs) {
   assert(c);
   assert(r);
+  assert(rs);
   if (!c)
     return false;
   if (!r->class && !r->name && !r->title)
     return false;
   bool res_class = true, res_name = true, res_title = true;
   if (r->class)
-    res_class = strcmp(c->class, r->class) == 0;
+    res_class = c->info->class && c->info->class == rs->class;
   if (r->name)
-    res_name = strcmp(c->name, r->name) == 0;
+    res_name = c->info->name && c->info->name == rs->name;
   if (r->title)
-    res_title = strcmp(c->title, r->title) == 0;
+    res_title = strcmp(NeuroTypeGetClientTitle(c), r->title) == 0;
   return res_class && res_name && res_title;
 }
 
@@ -78,18 +96,18 @@ static void set_rule(NeuroClient *c, const NeuroRule *r) {
 static void apply_rules(NeuroClient *c) {
   assert(c);
   const NeuroRule *const *const rule_list = NeuroConfigGet()->rule_list;
-  if (!rule_list)
+  if (!rule_list || !rule_strings_)
     return;
 
   for (NeuroIndex i = 0U; rule_list[ i ]; ++i) {
     const NeuroRule *r = rule_list[ i ];
-    if (has_rule(c, r)) {
+    if (has_rule(c, r, rule_strings_ + i)) {
       set_rule(c, r);
       break;
     }
   }
 
-  if (!strcmp(c->name, NEURO_RULE_SCRATCHPAD_NAME))
+  if (c->info->name && c->info->name == scratchpad_name_)
     c->is_nsp = true;
 }
 
@@ -98,19 +116,56 @@ static void apply_rules(NeuroClient *c) {
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-NeuroClient *NeuroRuleNewClient(Window w, const XWindowAttributes *wa) {
-  if (!wa)
+// Init and Stop
+// NOTE: it must be called after NeuroCoreInit, which inits the string table
+bool NeuroRuleInit(void) {
+  scratchpad_name_ = NeuroTypeInternString(NEURO_RULE_SCRATCHPAD_NAME);
+  if (!scratchpad_name_)
+    return false;
+
+  const NeuroRule *const *const rule_list = NeuroConfigGet()->rule_list;
+  const NeuroIndex size = NeuroTypeArrayLength((const void *const *)rule_list);
+  rule_strings_ = (RuleStrings *)calloc(size + 1U, sizeof(RuleStrings));
+  if (!rule_strings_)
+    return false;
+
+  for (NeuroIndex i = 0U; i < size; ++i) {
+    const NeuroRule *const r = rule_list[ i ];
+    if ((r->class && !(rule_strings_[ i ].class = NeuroTypeInternString(r->class))) ||
+        (r->name && !(rule_strings_[ i ].name = NeuroTypeInternString(r->name)))) {
+      NeuroRuleStop();
+      return false;
+    }
+  }
+  return true;
+}
+
+void NeuroRuleStop(void) {
+  free(rule_strings_);
+  rule_strings_ = NULL;
+  scratchpad_name_ = NULL;
+}
+
+// The properties must have been fetched with NeuroSystemFetchWindowProperties, so no request is sent here
+NeuroClient *NeuroRuleNewClient(Window w, const NeuroSystemWindowProperties *wp) {
+  if (!wp)
     return NULL;
 
-  NeuroClient *c = NeuroTypeNewClient(w, wa);
+  NeuroClient *c = NeuroTypeNewClient(w, &wp->attributes);
   if (!c)
     return NULL;
 
-  if (is_free_size_hints(c))
+  if (is_free_size_hints(&wp->size_hints))
     c->free_setter_fn = NeuroRuleFreeSetterCenter;
+  NeuroTypeSetClientSizeHints(c, &wp->size_hints);
+  NeuroTypeSetClientNetStates(c, wp->net_states, wp->net_states_size);
   c->ws = NeuroCoreGetCurrStack();
-  NeuroClientUpdateClassAndName(&c, NULL);
-  NeuroClientUpdateTitle(&c, NULL);
+  c->info->class = NeuroTypeInternString(wp->class);
+  c->info->name = NeuroTypeInternString(wp->name);
+  if (!NeuroTypeSetClientTitle(c, wp->title ? wp->title : "")) {
+    NeuroTypeDeleteClient(c);
+    return NULL;
+  }
   apply_rules(c);
   return c;
 }
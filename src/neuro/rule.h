@@ -15,6 +15,7 @@
 
 // Includes
 #include "type.h"
+#include "system.h"
 
 // Defines
 #define NEURO_RULE_SCRATCHPAD_NAME "neurowm_scratchpad"
@@ -25,8 +26,12 @@
 // FUNCTION DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Init and Stop
+bool NeuroRuleInit(void);
+void NeuroRuleStop(void);
+
 // Basic Functions
-NeuroClient *NeuroRuleNewClient(Window w, const XWindowAttributes *wa);
+NeuroClient *NeuroRuleNewClient(Window w, const NeuroSystemWindowProperties *wp);
 void NeuroRuleSetLayoutRegion(NeuroRectangle *r, const NeuroClientPtrPtr c);
 void NeuroRuleSetClientRegion(NeuroRectangle *r, const NeuroClientPtrPtr c);
 
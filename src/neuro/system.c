@@ -15,6 +15,37 @@
 #include "system.h"
 #include "config.h"
 
+// Defines
+#define XCB_PROPERTY_MAX_LENGTH 2048  // In 32-bit units, longer string properties get truncated
+#define XCB_SIZE_HINTS_LENGTH 18  // In 32-bit units, see ICCCM 4.1.2.3
+#define BINDING_TABLE_MIN_SIZE 16  // Must be a power of 2
+#define BINDING_MOD_MASK (ShiftMask|ControlMask|Mod1Mask|Mod2Mask|Mod3Mask|Mod4Mask|Mod5Mask)
+#define NUM_LOCK_MASKS 4
+#define ATOM_NAME_SIZE 32
+#define ATOM_NET_OFFSET NEURO_SYSTEM_WMATOM_END
+#define ATOM_UTF8_STRING (ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_END)
+#define NUM_ATOMS (ATOM_UTF8_STRING + 1)  // WM, net and UTF8_STRING atoms
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// BindingEntry
+typedef struct BindingEntry BindingEntry;
+struct BindingEntry {
+  unsigned int code;  // Key code or button
+  unsigned int mod;  // Modifier mask without lock masks
+  const void *binding;  // NeuroKey or NeuroButton, NULL if the entry is empty
+};
+
+// BindingTable (open addressing hash table keyed by code and modifier mask, equal keys keep the binding list order)
+typedef struct BindingTable BindingTable;
+struct BindingTable {
+  BindingEntry *entries;
+  NeuroIndex size;  // Power of 2, at least twice the number of entries
+};
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE VARIABLE DEFINITION
@@ -30,7 +61,34 @@ static const int hidden_gaps_[ 4 ] = { 0 };
 static Cursor cursors_[ NEURO_SYSTEM_CURSOR_END ];
 static Atom wm_atoms_[ NEURO_SYSTEM_WMATOM_END ];
 static Atom net_atoms_[ NEURO_SYSTEM_NETATOM_END ];
+static Atom utf8_string_atom_;
 static NeuroColor colors_[ NEURO_SYSTEM_COLOR_END ];
+static char atom_names_[ NUM_ATOMS ][ ATOM_NAME_SIZE ] = {  // Not const because XInternAtoms takes char **
+  [ NEURO_SYSTEM_WMATOM_PROTOCOLS ] = "WM_PROTOCOLS",
+  [ NEURO_SYSTEM_WMATOM_DELETEWINDOW ] = "WM_DELETE_WINDOW",
+  [ NEURO_SYSTEM_WMATOM_STATE ] = "WM_STATE",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_SUPPORTED ] = "_NET_SUPPORTED",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_FULLSCREEN ] = "_NET_WM_STATE_FULLSCREEN",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_STATE ] = "_NET_WM_STATE",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_NAME ] = "_NET_WM_NAME",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_ACTIVE ] = "_NET_ACTIVE_WINDOW",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_CLOSEWINDOW ] = "_NET_CLOSE_WINDOW",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_STRUT ] = "_NET_WM_STRUT",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_SUPPORTINGWMCHECK ] = "_NET_SUPPORTING_WM_CHECK",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_HIDDEN ] = "_NET_WM_STATE_HIDDEN",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_SYNCREQUEST ] = "_NET_WM_SYNC_REQUEST",
+  [ ATOM_NET_OFFSET + NEURO_SYSTEM_NETATOM_SYNCREQUESTCOUNTER ] = "_NET_WM_SYNC_REQUEST_COUNTER",
+  [ ATOM_UTF8_STRING ] = "UTF8_STRING"
+};
+static unsigned long enter_notify_serial_ = 0UL;  // EnterNotify events with a lower serial are ignored
+static int sync_event_base_ = -1;  // -1 if the X server has no SYNC extension or neurowm was built without XSYNC
+
+// Bindings
+static BindingTable key_table_ = { NULL, 0U };
+static BindingTable button_table_ = { NULL, 0U };
+static unsigned int lock_masks_[ NUM_LOCK_MASKS ] = { 0U, LockMask };  // Every NumLock and CapsLock mix
+static NeuroIndex lock_masks_size_ = 2U;  // Number of different lock masks, see set_lock_masks
+static unsigned int num_lock_mask_ = 0U;
 
 // Version
 static const char *const version_ = PKG_NAME " " PKG_VERSION;
@@ -85,6 +143,79 @@ static int xerror_handler(Display *d, XErrorEvent *ee) {
   return -1;
 }
 
+// Interns all the atoms in a single round trip
+static bool set_atoms(void) {
+  char *names[ NUM_ATOMS ];
+  Atom atoms[ NUM_ATOMS ];
+  for (NeuroIndex i = 0U; i < NUM_ATOMS; ++i)
+    names[ i ] = atom_names_[ i ];
+  if (!XInternAtoms(display_, names, NUM_ATOMS, false, atoms))
+    return false;
+  for (NeuroIndex i = 0U; i < NEURO_SYSTEM_WMATOM_END; ++i)
+    wm_atoms_[ i ] = atoms[ i ];
+  for (NeuroIndex i = 0U; i < NEURO_SYSTEM_NETATOM_END; ++i)
+    net_atoms_[ i ] = atoms[ ATOM_NET_OFFSET + i ];
+  utf8_string_atom_ = atoms[ ATOM_UTF8_STRING ];
+  return true;
+}
+
+// Parses colors like "#1c1c1c" or "#fff"
+static bool parse_hex_color(const char *color, unsigned int rgb[ 3 ]) {
+  assert(color);
+  assert(rgb);
+  if (color[ 0 ] != '#')
+    return false;
+  const size_t len = strlen(color + 1);
+  if (len != 3 && len != 6)
+    return false;
+  const size_t digits = len / 3;
+  for (NeuroIndex i = 0U; i < 3; ++i) {
+    rgb[ i ] = 0U;
+    for (NeuroIndex j = 0U; j < digits; ++j) {
+      const char h = color[ 1 + i*digits + j ];
+      unsigned int d;
+      if (h >= '0' && h <= '9')
+        d = h - '0';
+      else if (h >= 'a' && h <= 'f')
+        d = h - 'a' + 10;
+      else if (h >= 'A' && h <= 'F')
+        d = h - 'A' + 10;
+      else
+        return false;
+      rgb[ i ] = rgb[ i ]*16U + d;
+    }
+    if (digits == 1)
+      rgb[ i ] *= 17U;
+  }
+  return true;
+}
+
+// Scales the 8-bit channel value to the bits of the visual mask
+static unsigned long get_channel_pixel(unsigned int value, unsigned long mask) {
+  if (!mask)
+    return 0UL;
+  int shift = 0, bits = 0;
+  while (!(mask & (1UL << shift)))
+    ++shift;
+  while (mask & (1UL << (shift + bits)))
+    ++bits;
+  const unsigned long v = bits >= 8 ? (unsigned long)value << (bits - 8) : (unsigned long)value >> (8 - bits);
+  return (v << shift) & mask;
+}
+
+// TrueColor visuals map colors to pixels directly, so there is no need to allocate them in the X server
+static bool get_true_color_pixel(const char *color, NeuroColor *pixel) {
+  assert(color);
+  assert(pixel);
+  const Visual *const v = DefaultVisual(display_, screen_);
+  unsigned int rgb[ 3 ];
+  if (v->class != TrueColor || !parse_hex_color(color, rgb))
+    return false;
+  *pixel = (NeuroColor)(get_channel_pixel(rgb[ 0 ], v->red_mask) | get_channel_pixel(rgb[ 1 ], v->green_mask) |
+      get_channel_pixel(rgb[ 2 ], v->blue_mask));
+  return true;
+}
+
 static bool set_colors_cursors_atoms(void) {
   if (!NeuroConfigGet()->normal_border_color || !NeuroConfigGet()->current_border_color ||
       !NeuroConfigGet()->old_border_color || !NeuroConfigGet()->free_border_color ||
@@ -103,26 +234,375 @@ static bool set_colors_cursors_atoms(void) {
   cursors_[ NEURO_SYSTEM_CURSOR_RESIZE ] = XCreateFontCursor(display_, XC_bottom_right_corner);
   cursors_[ NEURO_SYSTEM_CURSOR_MOVE ] = XCreateFontCursor(display_, XC_fleur);
 
-  // WM Atoms
-  wm_atoms_[ NEURO_SYSTEM_WMATOM_PROTOCOLS ] = XInternAtom(display_, "WM_PROTOCOLS", false);
-  wm_atoms_[ NEURO_SYSTEM_WMATOM_DELETEWINDOW ] = XInternAtom(display_, "WM_DELETE_WINDOW", false);
-
-  // Net Atoms
-  net_atoms_[ NEURO_SYSTEM_NETATOM_SUPPORTED ] = XInternAtom(display_, "_NET_SUPPORTED", false);
-  net_atoms_[ NEURO_SYSTEM_NETATOM_STATE ] = XInternAtom(display_, "_NET_WM_STATE", false);
-  net_atoms_[ NEURO_SYSTEM_NETATOM_NAME ] = XInternAtom(display_, "_NET_WM_NAME", false);
-  net_atoms_[ NEURO_SYSTEM_NETATOM_ACTIVE ] = XInternAtom(display_, "_NET_ACTIVE_WINDOW", false);
-  net_atoms_[ NEURO_SYSTEM_NETATOM_FULLSCREEN ] = XInternAtom(display_, "_NET_WM_STATE_FULLSCREEN", false);
-  net_atoms_[ NEURO_SYSTEM_NETATOM_STRUT ] = XInternAtom(display_, "_NET_WM_STRUT", false);
-  net_atoms_[ NEURO_SYSTEM_NETATOM_CLOSEWINDOW ] = XInternAtom(display_, "_NET_CLOSE_WINDOW", false);
+  // Atoms
+  return set_atoms();
+}
 
-  // EWMH support per view
+// The sync atoms are only advertised when the X server has the SYNC extension, see NeuroSystemGetSyncEventBase
+static void set_net_supported(void) {
+  static const NeuroSystemNetatom always_supported[] = { NEURO_SYSTEM_NETATOM_SUPPORTED,
+      NEURO_SYSTEM_NETATOM_FULLSCREEN, NEURO_SYSTEM_NETATOM_STATE, NEURO_SYSTEM_NETATOM_NAME,
+      NEURO_SYSTEM_NETATOM_ACTIVE, NEURO_SYSTEM_NETATOM_CLOSEWINDOW, NEURO_SYSTEM_NETATOM_STRUT,
+      NEURO_SYSTEM_NETATOM_SUPPORTINGWMCHECK, NEURO_SYSTEM_NETATOM_HIDDEN };
+  Atom supported[ NEURO_SYSTEM_NETATOM_END ];
+  int n = 0;
+  for (size_t i = 0U; i < sizeof(always_supported)/sizeof(NeuroSystemNetatom); ++i)
+    supported[ n++ ] = net_atoms_[ always_supported[ i ] ];
+  if (sync_event_base_ >= 0) {
+    supported[ n++ ] = net_atoms_[ NEURO_SYSTEM_NETATOM_SYNCREQUEST ];
+    supported[ n++ ] = net_atoms_[ NEURO_SYSTEM_NETATOM_SYNCREQUESTCOUNTER ];
+  }
   XChangeProperty(display_, root_, net_atoms_[ NEURO_SYSTEM_NETATOM_SUPPORTED ], XA_ATOM, 32, PropModeReplace,
-      (unsigned char *)net_atoms_, NEURO_SYSTEM_NETATOM_END);
+      (unsigned char *)supported, n);
+}
+
+static unsigned int clean_mod_mask(unsigned int mod) {
+  return mod & ~(num_lock_mask_ | LockMask) & BINDING_MOD_MASK;
+}
+
+static NeuroIndex hash_binding(unsigned int code, unsigned int mod) {
+  return (code * 2654435761U) ^ (mod * 40503U);
+}
+
+static void stop_binding_table(BindingTable *bt) {
+  assert(bt);
+  free(bt->entries);
+  bt->entries = NULL;
+  bt->size = 0U;
+}
+
+static bool init_binding_table(BindingTable *bt, NeuroIndex num) {
+  assert(bt);
+  NeuroIndex size = BINDING_TABLE_MIN_SIZE;
+  while (size < num*2U)
+    size *= 2U;
+  BindingEntry *const entries = (BindingEntry *)calloc(size, sizeof(BindingEntry));
+  if (!entries)
+    return false;
+  stop_binding_table(bt);
+  bt->entries = entries;
+  bt->size = size;
+  return true;
+}
+
+// The table is sized for every insertion, so it never fills, but the probes are bounded anyway
+static bool insert_binding(BindingTable *bt, unsigned int code, unsigned int mod, const void *binding) {
+  assert(bt);
+  assert(binding);
+  const NeuroIndex h = hash_binding(code, mod);
+  for (NeuroIndex it = 0U; it < bt->size; ++it) {
+    BindingEntry *const e = bt->entries + ((h + it) & (bt->size - 1U));
+    if (!e->binding) {
+      *e = (BindingEntry){ code, mod, binding };
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the next binding of the code and modifier mask, *it is the number of probes done so far (0 at first)
+static const void *find_binding(const BindingTable *bt, unsigned int code, unsigned int mod, NeuroIndex *it) {
+  assert(bt);
+  assert(it);
+  if (!bt->entries)
+    return NULL;
+  const NeuroIndex h = hash_binding(code, mod);
+  while (*it < bt->size) {
+    const BindingEntry *const e = bt->entries + ((h + (*it)++) & (bt->size - 1U));
+    if (!e->binding)
+      return NULL;
+    if (e->code == code && e->mod == mod)
+      return e->binding;
+  }
+  return NULL;
+}
+
+static unsigned int get_num_lock_mask(void) {
+  unsigned int mask = 0U;
+  const KeyCode code = XKeysymToKeycode(display_, XK_Num_Lock);
+  XModifierKeymap *const mm = XGetModifierMapping(display_);
+  if (!mm)
+    return mask;
+  for (int i = 0; code && i < 8; ++i)
+    for (int j = 0; j < mm->max_keypermod; ++j)
+      if (mm->modifiermap[ i*mm->max_keypermod + j ] == code)
+        mask = 1U << i;
+  XFreeModifiermap(mm);
+  return mask;
+}
+
+static NeuroIndex count_key_bindings(const NeuroKey *const *key_list, const KeySym *syms, int min, int max, int per) {
+  assert(key_list);
+  assert(syms);
+  NeuroIndex num = 0U;
+  for (int code = min; code <= max; ++code)
+    for (NeuroIndex i = 0U; syms[ (code - min)*per ] != NoSymbol && key_list[ i ]; ++i)
+      if (key_list[ i ]->key == syms[ (code - min)*per ])
+        ++num;
+  return num;
+}
 
+// A key binding matches the key codes whose first key symbol is the binding key symbol, the table has an entry for each
+static bool set_key_table(const NeuroKey *const *key_list) {
+  if (!key_list)
+    return init_binding_table(&key_table_, 0U);
+  int min = 0, max = 0, per = 0;
+  XDisplayKeycodes(display_, &min, &max);
+  KeySym *const syms = XGetKeyboardMapping(display_, min, max - min + 1, &per);
+  if (!syms)
+    return false;
+  bool is_ok = init_binding_table(&key_table_, count_key_bindings(key_list, syms, min, max, per));
+  for (int code = min; is_ok && code <= max; ++code) {
+    const KeySym sym = syms[ (code - min)*per ];
+    if (sym == NoSymbol)
+      continue;
+    for (NeuroIndex i = 0U; is_ok && key_list[ i ]; ++i)
+      if (key_list[ i ]->key == sym)
+        is_ok = insert_binding(&key_table_, code, clean_mod_mask(key_list[ i ]->mod), key_list[ i ]);
+  }
+  XFree(syms);
+  return is_ok;
+}
+
+static bool set_button_table(const NeuroButton *const *button_list) {
+  if (!init_binding_table(&button_table_, NeuroTypeArrayLength((const void *const *)button_list)))
+    return false;
+  for (NeuroIndex i = 0U; button_list && button_list[ i ]; ++i)
+    if (!insert_binding(&button_table_, button_list[ i ]->button, clean_mod_mask(button_list[ i ]->mod),
+        button_list[ i ]))
+      return false;
   return true;
 }
 
+// Without NumLock (or with NumLock on the CapsLock modifier) only the CapsLock mixes are grabbed
+static void set_lock_masks(void) {
+  num_lock_mask_ = get_num_lock_mask();
+  lock_masks_size_ = 2U;
+  if (!num_lock_mask_ || num_lock_mask_ == LockMask)
+    return;
+  lock_masks_[ lock_masks_size_++ ] = num_lock_mask_;
+  lock_masks_[ lock_masks_size_++ ] = num_lock_mask_ | LockMask;
+}
+
+static char *copy_string(const char *str, size_t len) {
+  assert(str);
+  char *const copy = (char *)malloc(len + 1U);
+  if (!copy)
+    return NULL;
+  memcpy(copy, str, len);
+  copy[ len ] = '\0';
+  return copy;
+}
+
+// Returns a new heap string with the first string of the text property, or NULL
+static char *get_text_property_string(const XTextProperty *tp) {
+  assert(tp);
+  if (!tp->value || !tp->nitems)
+    return NULL;
+  if (tp->encoding == XA_STRING && tp->format == 8)
+    return copy_string((const char *)tp->value, strnlen((const char *)tp->value, tp->nitems));
+  char *str = NULL;
+  char **list = NULL;
+  int n = 0;
+  if (XmbTextPropertyToTextList(display_, tp, &list, &n) >= Success && n > 0 && list[ 0 ])
+    str = copy_string(list[ 0 ], strlen(list[ 0 ]));
+  if (list)
+    XFreeStringList(list);
+  return str;
+}
+
+#ifdef XCB
+static void set_xcb_window_attributes(XWindowAttributes *wa, const xcb_get_window_attributes_reply_t *ar,
+    const xcb_get_geometry_reply_t *gr) {
+  assert(wa);
+  assert(ar);
+  assert(gr);
+  memset(wa, 0, sizeof(XWindowAttributes));
+  wa->x = gr->x;
+  wa->y = gr->y;
+  wa->width = gr->width;
+  wa->height = gr->height;
+  wa->border_width = gr->border_width;
+  wa->depth = gr->depth;
+  wa->root = gr->root;
+  wa->class = ar->_class;
+  wa->bit_gravity = ar->bit_gravity;
+  wa->win_gravity = ar->win_gravity;
+  wa->backing_store = ar->backing_store;
+  wa->backing_planes = ar->backing_planes;
+  wa->backing_pixel = ar->backing_pixel;
+  wa->save_under = ar->save_under;
+  wa->colormap = ar->colormap;
+  wa->map_installed = ar->map_is_installed;
+  wa->map_state = ar->map_state;
+  wa->all_event_masks = ar->all_event_masks;
+  wa->your_event_mask = ar->your_event_mask;
+  wa->do_not_propagate_mask = ar->do_not_propagate_mask;
+  wa->override_redirect = ar->override_redirect;
+  wa->screen = ScreenOfDisplay(display_, screen_);
+}
+
+static void set_xcb_size_hints(XSizeHints *sh, const xcb_get_property_reply_t *pr) {
+  assert(sh);
+  memset(sh, 0, sizeof(XSizeHints));
+  if (!pr || pr->type != XA_WM_SIZE_HINTS || pr->format != 32)
+    return;
+  const int len = xcb_get_property_value_length(pr) / 4;
+  if (len < XCB_SIZE_HINTS_LENGTH - 3)  // Pre-ICCCM hints have no base size and gravity
+    return;
+  const uint32_t *const v = (const uint32_t *)xcb_get_property_value(pr);
+  sh->flags = v[ 0 ];
+  sh->x = v[ 1 ];
+  sh->y = v[ 2 ];
+  sh->width = v[ 3 ];
+  sh->height = v[ 4 ];
+  sh->min_width = v[ 5 ];
+  sh->min_height = v[ 6 ];
+  sh->max_width = v[ 7 ];
+  sh->max_height = v[ 8 ];
+  sh->width_inc = v[ 9 ];
+  sh->height_inc = v[ 10 ];
+  sh->min_aspect.x = v[ 11 ];
+  sh->min_aspect.y = v[ 12 ];
+  sh->max_aspect.x = v[ 13 ];
+  sh->max_aspect.y = v[ 14 ];
+  if (len < XCB_SIZE_HINTS_LENGTH) {
+    sh->flags &= ~(PBaseSize | PWinGravity);
+    return;
+  }
+  sh->base_width = v[ 15 ];
+  sh->base_height = v[ 16 ];
+  sh->win_gravity = v[ 17 ];
+}
+
+// WM_CLASS holds the name and the class, both null-terminated
+static void set_xcb_class_hint(NeuroSystemWindowProperties *wp, const xcb_get_property_reply_t *pr) {
+  assert(wp);
+  if (!pr || pr->format != 8)
+    return;
+  const int len = xcb_get_property_value_length(pr);
+  if (len <= 0)
+    return;
+  const char *const v = (const char *)xcb_get_property_value(pr);
+  const size_t name_len = strnlen(v, len);
+  wp->name = copy_string(v, name_len);
+  if (name_len + 1U < (size_t)len)
+    wp->class = copy_string(v + name_len + 1U, strnlen(v + name_len + 1U, len - name_len - 1U));
+}
+
+static char *get_xcb_title(const xcb_get_property_reply_t *pr) {
+  if (!pr || pr->format != 8 || xcb_get_property_value_length(pr) <= 0)
+    return NULL;
+  XTextProperty tp;
+  tp.value = (unsigned char *)xcb_get_property_value(pr);
+  tp.encoding = pr->type;
+  tp.format = pr->format;
+  tp.nitems = xcb_get_property_value_length(pr);
+  return get_text_property_string(&tp);
+}
+
+// Sends all the requests before waiting for any reply, so the properties cost a single round trip
+static bool fetch_xcb_window_properties(NeuroSystemWindowProperties *wp, Window w) {
+  assert(wp);
+  xcb_connection_t *const xc = XGetXCBConnection(display_);
+  const xcb_window_t xw = (xcb_window_t)w;
+  const xcb_get_window_attributes_cookie_t ac = xcb_get_window_attributes(xc, xw);
+  const xcb_get_geometry_cookie_t gc = xcb_get_geometry(xc, xw);
+  const xcb_get_property_cookie_t hc = xcb_get_property(xc, 0, xw, XA_WM_NORMAL_HINTS, XA_WM_SIZE_HINTS, 0,
+      XCB_SIZE_HINTS_LENGTH);
+  const xcb_get_property_cookie_t cc = xcb_get_property(xc, 0, xw, XA_WM_CLASS, XA_STRING, 0,
+      XCB_PROPERTY_MAX_LENGTH);
+  const xcb_get_property_cookie_t nc = xcb_get_property(xc, 0, xw, net_atoms_[ NEURO_SYSTEM_NETATOM_NAME ],
+      XCB_GET_PROPERTY_TYPE_ANY, 0, XCB_PROPERTY_MAX_LENGTH);
+  const xcb_get_property_cookie_t tc = xcb_get_property(xc, 0, xw, XA_WM_NAME, XCB_GET_PROPERTY_TYPE_ANY, 0,
+      XCB_PROPERTY_MAX_LENGTH);
+  const xcb_get_property_cookie_t trc = xcb_get_property(xc, 0, xw, XA_WM_TRANSIENT_FOR, XA_WINDOW, 0, 1);
+  const xcb_get_property_cookie_t sc = xcb_get_property(xc, 0, xw, net_atoms_[ NEURO_SYSTEM_NETATOM_STATE ], XA_ATOM, 0,
+      NEURO_NET_STATES_MAX);
+
+  // Collect the replies, all of them must be read even if the window is gone
+  xcb_generic_error_t *err[ 8 ] = { NULL };
+  xcb_get_window_attributes_reply_t *const ar = xcb_get_window_attributes_reply(xc, ac, err + 0);
+  xcb_get_geometry_reply_t *const gr = xcb_get_geometry_reply(xc, gc, err + 1);
+  xcb_get_property_reply_t *const hr = xcb_get_property_reply(xc, hc, err + 2);
+  xcb_get_property_reply_t *const cr = xcb_get_property_reply(xc, cc, err + 3);
+  xcb_get_property_reply_t *const nr = xcb_get_property_reply(xc, nc, err + 4);
+  xcb_get_property_reply_t *const tr = xcb_get_property_reply(xc, tc, err + 5);
+  xcb_get_property_reply_t *const trr = xcb_get_property_reply(xc, trc, err + 6);
+  xcb_get_property_reply_t *const sr = xcb_get_property_reply(xc, sc, err + 7);
+
+  const bool ret = ar && gr;
+  if (ret) {
+    set_xcb_window_attributes(&wp->attributes, ar, gr);
+    set_xcb_size_hints(&wp->size_hints, hr);
+    set_xcb_class_hint(wp, cr);
+    wp->title = get_xcb_title(nr);
+    if (!wp->title)
+      wp->title = get_xcb_title(tr);
+    if (trr && trr->type == XA_WINDOW && trr->format == 32 && xcb_get_property_value_length(trr) >= 4) {
+      wp->is_transient = true;
+      wp->transient_for = *(const xcb_window_t *)xcb_get_property_value(trr);
+    }
+    if (sr && sr->type == XA_ATOM && sr->format == 32) {
+      const xcb_atom_t *const states = (const xcb_atom_t *)xcb_get_property_value(sr);
+      const int n = xcb_get_property_value_length(sr) / 4;
+      for (int i = 0; i < n && wp->net_states_size < NEURO_NET_STATES_MAX; ++i)
+        wp->net_states[ wp->net_states_size++ ] = states[ i ];
+    }
+  }
+
+  // Clean up
+  for (NeuroIndex i = 0U; i < 8U; ++i)
+    free(err[ i ]);
+  free(ar);
+  free(gr);
+  free(hr);
+  free(cr);
+  free(nr);
+  free(tr);
+  free(trr);
+  free(sr);
+  return ret;
+}
+#else
+static bool fetch_xlib_title(NeuroSystemWindowProperties *wp, Window w, Atom atom) {
+  assert(wp);
+  XTextProperty tp;
+  if (!XGetTextProperty(display_, w, &tp, atom))
+    return false;
+  wp->title = get_text_property_string(&tp);
+  if (tp.value)
+    XFree(tp.value);
+  return wp->title != NULL;
+}
+
+// Fallback without XCB, every property costs a round trip
+static bool fetch_xlib_window_properties(NeuroSystemWindowProperties *wp, Window w) {
+  assert(wp);
+  if (!XGetWindowAttributes(display_, w, &wp->attributes))
+    return false;
+  long msize = 0L;
+  if (!XGetWMNormalHints(display_, w, &wp->size_hints, &msize))
+    wp->size_hints.flags = 0L;
+  XClassHint ch = { NULL, NULL };
+  if (XGetClassHint(display_, w, &ch)) {
+    if (ch.res_name) {
+      wp->name = copy_string(ch.res_name, strlen(ch.res_name));
+      XFree(ch.res_name);
+    }
+    if (ch.res_class) {
+      wp->class = copy_string(ch.res_class, strlen(ch.res_class));
+      XFree(ch.res_class);
+    }
+  }
+  if (!fetch_xlib_title(wp, w, net_atoms_[ NEURO_SYSTEM_NETATOM_NAME ]))
+    fetch_xlib_title(wp, w, XA_WM_NAME);
+  wp->is_transient = XGetTransientForHint(display_, w, &wp->transient_for);
+  wp->net_states_size = NeuroSystemGetWindowNetStates(w, wp->net_states, NEURO_NET_STATES_MAX);
+  return true;
+}
+#endif
+
 // Note: This helper function will always exit
 static void run_command(const char *const *cmd) {
   assert(cmd);
@@ -199,13 +679,24 @@ bool NeuroSystemInit(void) {
   XSetErrorHandler(xerror_handler);
   XSync(display_, false);
 
-  // Grab key bindings
-  NeuroSystemGrabKeys(root_, NeuroConfigGet()->key_list);
+#ifdef XSYNC
+  // SYNC extension, used to pace interactive resizes
+  int sync_error_base = 0, sync_major = 0, sync_minor = 0;
+  if (!XSyncQueryExtension(display_, &sync_event_base_, &sync_error_base) ||
+      !XSyncInitialize(display_, &sync_major, &sync_minor))
+    sync_event_base_ = -1;
+#endif
 
-  return true;
+  // EWMH support per view
+  set_net_supported();
+
+  // Set the binding tables and grab key bindings
+  return NeuroSystemUpdateBindings();
 }
 
 void NeuroSystemStop(void) {
+  stop_binding_table(&key_table_);
+  stop_binding_table(&button_table_);
   XFreeCursor(display_, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_NORMAL));
   XFreeCursor(display_, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
   XFreeCursor(display_, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
@@ -237,6 +728,23 @@ const int *NeuroSystemGetHiddenGaps(void) {
   return hidden_gaps_;
 }
 
+// Enter notify events up to the last request sent were caused by the window manager, not by the pointer
+// Events carry the serial of the last request processed by the server, so a no-op request marks the point after which
+// the pointer crossings are not caused by the requests sent so far
+void NeuroSystemIgnoreEnterNotify(void) {
+  NeuroSystemIgnoreEnterNotifyBefore(NextRequest(display_));
+  XNoOp(display_);
+}
+
+void NeuroSystemIgnoreEnterNotifyBefore(unsigned long serial) {
+  enter_notify_serial_ = serial;
+}
+
+// Serials wrap around, so they are compared by their difference
+bool NeuroSystemIsEnterNotifyIgnored(unsigned long serial) {
+  return (long)(serial - enter_notify_serial_) < 0L;
+}
+
 void NeuroSystemGetPointerWindowLocation(NeuroPoint *p, Window *w) {
   Window root_win = 0UL, child_win = 0UL;
   int px = 0, py = 0, xc = 0, yc = 0;
@@ -258,12 +766,19 @@ Atom NeuroSystemGetNetAtom(NeuroSystemNetatom a) {
   return net_atoms_[ a ];
 }
 
+int NeuroSystemGetSyncEventBase(void) {
+  return sync_event_base_;
+}
+
 NeuroColor NeuroSystemGetColor(NeuroSystemColor c) {
   return colors_[ c ];
 }
 
 NeuroColor NeuroSystemGetColorFromHex(const char* color) {
   assert(color);
+  NeuroColor pixel = 0UL;
+  if (get_true_color_pixel(color, &pixel))
+    return pixel;
   XColor c;
   if (!XAllocNamedColor(display_, DefaultColormap(display_, screen_), color, &c, &c))
     NeuroSystemError(__func__, "Could not allocate color");
@@ -272,11 +787,56 @@ NeuroColor NeuroSystemGetColorFromHex(const char* color) {
 
 void NeuroSystemChangeWmName(const char *name) {
   assert(name);
-  const Atom netwmcheck = XInternAtom(display_, "_NET_SUPPORTING_WM_CHECK", false);
-  const Atom netwmname = XInternAtom(display_, "_NET_WM_NAME", false);
-  const Atom utf8_str = XInternAtom(display_, "UTF8_STRING", false);
-  XChangeProperty(display_, root_, netwmcheck, XA_WINDOW, 32, PropModeReplace, (unsigned char *)&root_, 1);
-  XChangeProperty(display_, root_, netwmname, utf8_str, 8, PropModeReplace, (const unsigned char *)name, strlen(name));
+  XChangeProperty(display_, root_, net_atoms_[ NEURO_SYSTEM_NETATOM_SUPPORTINGWMCHECK ], XA_WINDOW, 32, PropModeReplace,
+      (unsigned char *)&root_, 1);
+  XChangeProperty(display_, root_, net_atoms_[ NEURO_SYSTEM_NETATOM_NAME ], utf8_string_atom_, 8, PropModeReplace,
+      (const unsigned char *)name, strlen(name));
+}
+
+bool NeuroSystemFetchWindowProperties(NeuroSystemWindowProperties *wp, Window w) {
+  if (!wp)
+    return false;
+  memset(wp, 0, sizeof(NeuroSystemWindowProperties));
+  wp->transient_for = None;
+#ifdef XCB
+  const bool ret = fetch_xcb_window_properties(wp, w);
+#else
+  const bool ret = fetch_xlib_window_properties(wp, w);
+#endif
+  if (!ret)
+    NeuroSystemFreeWindowProperties(wp);
+  return ret;
+}
+
+void NeuroSystemFreeWindowProperties(NeuroSystemWindowProperties *wp) {
+  if (!wp)
+    return;
+  free(wp->class);
+  wp->class = NULL;
+  free(wp->name);
+  wp->name = NULL;
+  free(wp->title);
+  wp->title = NULL;
+}
+
+// Returns the number of _NET_WM_STATE atoms of the window stored in states, at most size
+NeuroIndex NeuroSystemGetWindowNetStates(Window w, Atom *states, NeuroIndex size) {
+  if (!states)
+    return 0U;
+  Atom type = None;
+  int format = 0;
+  unsigned long n = 0UL, after = 0UL;
+  unsigned char *prop = NULL;
+  if (Success != XGetWindowProperty(display_, w, net_atoms_[ NEURO_SYSTEM_NETATOM_STATE ], 0L, (long)size, false,
+      XA_ATOM, &type, &format, &n, &after, &prop))
+    return 0U;
+  NeuroIndex ret = 0U;
+  if (prop && type == XA_ATOM && format == 32)
+    for (; ret < n && ret < size; ++ret)
+      states[ ret ] = ((const Atom *)(void *)prop)[ ret ];
+  if (prop)
+    XFree(prop);
+  return ret;
 }
 
 // System functions
@@ -372,6 +932,30 @@ void NeuroSystemError(const char *function_name, const char *msg) {
 }
 
 // Binding functions
+// NOTE: it must be called again when the keyboard mapping changes, the grabs of the old mapping are released first
+bool NeuroSystemUpdateBindings(void) {
+  XUngrabKey(display_, AnyKey, AnyModifier, root_);
+  set_lock_masks();
+  if (!set_key_table(NeuroConfigGet()->key_list) || !set_button_table(NeuroConfigGet()->button_list))
+    return false;
+  NeuroSystemGrabKeys(root_, NeuroConfigGet()->key_list);
+  return true;
+}
+
+// Returns the next key binding of the key code and modifier state, *it must be 0 at the first call
+const NeuroKey *NeuroSystemGetKeyBinding(unsigned int code, unsigned int state, NeuroIndex *it) {
+  if (!it)
+    return NULL;
+  return (const NeuroKey *)find_binding(&key_table_, code, clean_mod_mask(state), it);
+}
+
+// Returns the next button binding of the button and modifier state, *it must be 0 at the first call
+const NeuroButton *NeuroSystemGetButtonBinding(unsigned int button, unsigned int state, NeuroIndex *it) {
+  if (!it)
+    return NULL;
+  return (const NeuroButton *)find_binding(&button_table_, button, clean_mod_mask(state), it);
+}
+
 void NeuroSystemGrabKeys(Window w, const NeuroKey *const *key_list) {
   if (!key_list)
     return;
@@ -379,8 +963,10 @@ void NeuroSystemGrabKeys(Window w, const NeuroKey *const *key_list) {
   for (NeuroIndex i = 0U; key_list[ i ]; ++i) {
     const NeuroKey *const k = key_list[ i ];
     const KeyCode code = XKeysymToKeycode(display_, k->key);
-    if (code)
-      XGrabKey(display_, code, k->mod, w, true, GrabModeAsync, GrabModeAsync);
+    if (!code)
+      continue;
+    for (NeuroIndex j = 0U; j < lock_masks_size_; ++j)
+      XGrabKey(display_, code, k->mod | lock_masks_[ j ], w, true, GrabModeAsync, GrabModeAsync);
   }
 }
 
@@ -390,8 +976,10 @@ void NeuroSystemUngrabKeys(Window w, const NeuroKey *const *key_list) {
   for (NeuroIndex i = 0U; key_list[ i ]; ++i) {
     const NeuroKey *const k = key_list[ i ];
     const KeyCode code = XKeysymToKeycode(display_, k->key);
-    if (code)
-      XUngrabKey(display_, code, k->mod, w);
+    if (!code)
+      continue;
+    for (NeuroIndex j = 0U; j < lock_masks_size_; ++j)
+      XUngrabKey(display_, code, k->mod | lock_masks_[ j ], w);
   }
 }
 
@@ -401,8 +989,9 @@ void NeuroSystemGrabButtons(Window w, const NeuroButton *const *button_list) {
   XUngrabButton(display_, AnyButton, AnyModifier, w);
   for (NeuroIndex i = 0U; button_list[ i ]; ++i) {
     const NeuroButton *const b = button_list[ i ];
-    XGrabButton(display_, b->button, b->mod, w, false, ButtonPressMask|ButtonReleaseMask, GrabModeAsync, GrabModeSync,
-        None, None);
+    for (NeuroIndex j = 0U; j < lock_masks_size_; ++j)
+      XGrabButton(display_, b->button, b->mod | lock_masks_[ j ], w, false, ButtonPressMask|ButtonReleaseMask,
+          GrabModeAsync, GrabModeSync, None, None);
   }
 }
 
@@ -411,8 +1000,10 @@ void NeuroSystemUngrabButtons(Window w, const NeuroButton *const *button_list) {
     return;
   for (NeuroIndex i = 0U; button_list[ i ]; ++i) {
     const NeuroButton *b = button_list[ i ];
-    if (b->ungrab_on_focus)
-      XUngrabButton(display_, b->button, b->mod, w);
+    if (!b->ungrab_on_focus)
+      continue;
+    for (NeuroIndex j = 0U; j < lock_masks_size_; ++j)
+      XUngrabButton(display_, b->button, b->mod | lock_masks_[ j ], w);
   }
 }
 
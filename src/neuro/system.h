@@ -18,7 +18,6 @@
 
 // Defines
 #define NEURO_SYSTEM_CLIENT_MASK (FocusChangeMask|PropertyChangeMask|StructureNotifyMask|EnterWindowMask)
-#define NEURO_SYSTEM_CLIENT_MASK_NO_ENTER (FocusChangeMask|PropertyChangeMask|StructureNotifyMask)
 #define NEURO_SYSTEM_ROOT_MASK (SubstructureRedirectMask|SubstructureNotifyMask|ButtonPressMask|StructureNotifyMask|\
                                 NEURO_SYSTEM_CLIENT_MASK)
 
@@ -40,6 +39,7 @@ typedef enum NeuroSystemCursor NeuroSystemCursor;
 enum NeuroSystemWmatom {
   NEURO_SYSTEM_WMATOM_PROTOCOLS = 0,
   NEURO_SYSTEM_WMATOM_DELETEWINDOW,
+  NEURO_SYSTEM_WMATOM_STATE,
   NEURO_SYSTEM_WMATOM_END
 };
 typedef enum NeuroSystemWmatom NeuroSystemWmatom;
@@ -53,6 +53,10 @@ enum NeuroSystemNetatom {
   NEURO_SYSTEM_NETATOM_ACTIVE,
   NEURO_SYSTEM_NETATOM_CLOSEWINDOW,
   NEURO_SYSTEM_NETATOM_STRUT,
+  NEURO_SYSTEM_NETATOM_SUPPORTINGWMCHECK,
+  NEURO_SYSTEM_NETATOM_HIDDEN,
+  NEURO_SYSTEM_NETATOM_SYNCREQUEST,
+  NEURO_SYSTEM_NETATOM_SYNCREQUESTCOUNTER,
   NEURO_SYSTEM_NETATOM_END
 };
 typedef enum NeuroSystemNetatom NeuroSystemNetatom;
@@ -68,6 +72,20 @@ enum NeuroSystemColor {
 };
 typedef enum NeuroSystemColor NeuroSystemColor;
 
+// NeuroSystemWindowProperties (properties read when managing a window, the strings are owned by it)
+struct NeuroSystemWindowProperties {
+  XWindowAttributes attributes;
+  XSizeHints size_hints;  // The flags are 0 if the window has no normal hints
+  char *class;            // NULL if the window has no class hint
+  char *name;
+  char *title;            // NULL if the window has no title
+  bool is_transient;
+  Window transient_for;
+  Atom net_states[ NEURO_NET_STATES_MAX ];  // _NET_WM_STATE, set by the client before mapping the window
+  NeuroIndex net_states_size;
+};
+typedef struct NeuroSystemWindowProperties NeuroSystemWindowProperties;
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // FUNCTION DECLARATION
@@ -82,13 +100,20 @@ int NeuroSystemGetScreen(void);
 const NeuroRectangle *NeuroSystemGetScreenRegion(void);
 const NeuroRectangle *NeuroSystemGetHiddenRegion(void);
 const int *NeuroSystemGetHiddenGaps(void);
+void NeuroSystemIgnoreEnterNotify(void);
+void NeuroSystemIgnoreEnterNotifyBefore(unsigned long serial);
+bool NeuroSystemIsEnterNotifyIgnored(unsigned long serial);
 void NeuroSystemGetPointerWindowLocation(NeuroPoint *p, Window *w);
 Cursor NeuroSystemGetCursor(NeuroSystemCursor c);
 Atom NeuroSystemGetWmAtom(NeuroSystemWmatom a);
 Atom NeuroSystemGetNetAtom(NeuroSystemNetatom a);
+int NeuroSystemGetSyncEventBase(void);
 NeuroColor NeuroSystemGetColor(NeuroSystemColor c);
 NeuroColor NeuroSystemGetColorFromHex(const char *color);
 void NeuroSystemChangeWmName(const char *name);
+bool NeuroSystemFetchWindowProperties(NeuroSystemWindowProperties *wp, Window w);
+void NeuroSystemFreeWindowProperties(NeuroSystemWindowProperties *wp);
+NeuroIndex NeuroSystemGetWindowNetStates(Window w, Atom *states, NeuroIndex size);
 
 // System functions
 const char *NeuroSystemGetVersion(void);
@@ -100,6 +125,9 @@ int NeuroSystemSpawnPipe(const char *const *cmd, pid_t *p);
 void NeuroSystemError(const char *function_name, const char *msg);
 
 // Binding functions
+bool NeuroSystemUpdateBindings(void);
+const NeuroKey *NeuroSystemGetKeyBinding(unsigned int code, unsigned int state, NeuroIndex *it);
+const NeuroButton *NeuroSystemGetButtonBinding(unsigned int button, unsigned int state, NeuroIndex *it);
 void NeuroSystemGrabKeys(Window w, const NeuroKey *const *key_list);
 void NeuroSystemUngrabKeys(Window w, const NeuroKey *const *key_list);
 void NeuroSystemGrabButtons(Window w, const NeuroButton *const *button_list);
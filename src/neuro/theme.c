@@ -172,6 +172,10 @@ void NeuroThemeNnoellLoggerMonitorCurrLayoutMod(const NeuroMonitor *m, char *str
       strncat(tmp, "^fg(" NEURO_THEME_NNOELL_COLOR_GREEN ")X^fg()", NEURO_DZEN_LOGGER_MAX - strlen(tmp) - 1);
     if (l->mod & NEURO_LAYOUT_MOD_REFLECTY)
       strncat(tmp, "^fg(" NEURO_THEME_NNOELL_COLOR_GREEN ")Y^fg()", NEURO_DZEN_LOGGER_MAX - strlen(tmp) - 1);
+    if (l->mod & NEURO_LAYOUT_MOD_SIZEHINTS)
+      strncat(tmp, "^fg(" NEURO_THEME_NNOELL_COLOR_GREEN ")H^fg()", NEURO_DZEN_LOGGER_MAX - strlen(tmp) - 1);
+    if (l->mod & NEURO_LAYOUT_MOD_OUTLINE)
+      strncat(tmp, "^fg(" NEURO_THEME_NNOELL_COLOR_GREEN ")O^fg()", NEURO_DZEN_LOGGER_MAX - strlen(tmp) - 1);
   }
   NeuroDzenWrapDzenBox(tmp2, tmp, &boxpp_nnoell_white_);
   NeuroDzenWrapDzenBox(str, "MOD", &boxpp_nnoell_blue2_);
@@ -203,7 +207,7 @@ void NeuroThemeNnoellLoggerMonitorCurrTitle(const NeuroMonitor *m, char *str) {
     return;
 
   static char tmp[ NEURO_DZEN_LOGGER_MAX ], tmp2[ NEURO_DZEN_LOGGER_MAX ];
-  NeuroDzenWrapDzenBox(tmp, NEURO_CLIENT_PTR(c)->title, &boxpp_nnoell_white_);
+  NeuroDzenWrapDzenBox(tmp, NeuroTypeGetClientTitle(NEURO_CLIENT_PTR(c)), &boxpp_nnoell_white_);
   NeuroDzenWrapDzenBox(tmp2, "FOCUS", &boxpp_nnoell_white2b_);
   NeuroDzenWrapClickArea(str, tmp2, &ca_nnoell_title_);
   strncat(str, tmp, NEURO_DZEN_LOGGER_MAX - strlen(str) - 1);
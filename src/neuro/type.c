@@ -17,16 +17,223 @@
 #include "rule.h"
 #include "system.h"
 
+// Defines
+#define POOL_CACHE_LINE_SIZE 64  // Chunk alignment, the chunk header takes a whole line
+#define POOL_ITEM_ALIGN 16
+#define CLIENT_POOL_CHUNK_ITEMS 32
+#define STRING_TABLE_MIN_SIZE 64  // Must be a power of 2
+#define TITLE_MIN_SIZE 32
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// NeuroPoolChunk (the items follow the header, starting at the next cache line)
+struct NeuroPoolChunk {
+  NeuroPoolChunk *next;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Client pools (hot and cold parts)
+static NeuroPool client_pool_;
+static NeuroPool client_info_pool_;
+
+// String table (open addressing set of interned strings, never shrinks until NeuroTypeStop)
+static char **string_table_ = NULL;
+static NeuroIndex string_table_size_ = 0U;
+static NeuroIndex string_table_num_ = 0U;
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE FUNCTION DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+static size_t round_up_size(size_t size, size_t align) {
+  return ((size + align - 1U) / align) * align;
+}
+
+static bool add_pool_chunk(NeuroPool *p) {
+  assert(p);
+  const size_t chunk_size = round_up_size(POOL_CACHE_LINE_SIZE + p->item_size*p->chunk_items, POOL_CACHE_LINE_SIZE);
+  NeuroPoolChunk *const chunk = (NeuroPoolChunk *)aligned_alloc(POOL_CACHE_LINE_SIZE, chunk_size);
+  if (!chunk)
+    return false;
+  p->stats.heap_calls++;
+  chunk->next = p->chunks;
+  p->chunks = chunk;
+
+  // Push the new items into the free list backwards, so that they are handed out in address order
+  char *const items = (char *)chunk + POOL_CACHE_LINE_SIZE;
+  for (NeuroIndex i = p->chunk_items; i > 0U; --i) {
+    void **const item = (void **)(void *)(items + (i - 1U)*p->item_size);
+    *item = p->free_list;
+    p->free_list = item;
+  }
+  p->stats.capacity += p->chunk_items;
+  p->stats.chunks++;
+  return true;
+}
+
+
+// FNV-1a
+static size_t hash_string(const char *str) {
+  assert(str);
+  size_t h = 2166136261U;
+  for (const unsigned char *p = (const unsigned char *)str; *p; ++p)
+    h = (h ^ *p) * 16777619U;
+  return h;
+}
+
+static char **find_string_slot(char **table, NeuroIndex size, const char *str) {
+  assert(table);
+  assert(str);
+  NeuroIndex i = hash_string(str) & (size - 1U);
+  while (table[ i ] && strcmp(table[ i ], str))
+    i = (i + 1U) & (size - 1U);
+  return table + i;
+}
+
+static bool grow_string_table(void) {
+  const NeuroIndex new_size = string_table_size_ ? string_table_size_*2U : STRING_TABLE_MIN_SIZE;
+  char **const new_table = (char **)calloc(new_size, sizeof(char *));
+  if (!new_table)
+    return false;
+  for (NeuroIndex i = 0U; i < string_table_size_; ++i)
+    if (string_table_[ i ])
+      *find_string_slot(new_table, new_size, string_table_[ i ]) = string_table_[ i ];
+  free(string_table_);
+  string_table_ = new_table;
+  string_table_size_ = new_size;
+  return true;
+}
+
+static void stop_string_table(void) {
+  for (NeuroIndex i = 0U; i < string_table_size_; ++i)
+    free(string_table_[ i ]);
+  free(string_table_);
+  string_table_ = NULL;
+  string_table_size_ = 0U;
+  string_table_num_ = 0U;
+}
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Pool
+bool NeuroTypePoolInit(NeuroPool *p, size_t item_size, NeuroIndex chunk_items) {
+  if (!p || item_size == 0U || chunk_items == 0U)
+    return false;
+  p->item_size = round_up_size(item_size < sizeof(void *) ? sizeof(void *) : item_size, POOL_ITEM_ALIGN);
+  p->chunk_items = chunk_items;
+  p->free_list = NULL;
+  p->chunks = NULL;
+  memset(&p->stats, 0, sizeof(NeuroPoolStats));
+  return true;
+}
+
+// NOTE: it frees all the chunks, so every item handed out by the pool becomes invalid
+void NeuroTypePoolStop(NeuroPool *p) {
+  if (!p)
+    return;
+  NeuroPoolChunk *chunk = p->chunks;
+  while (chunk) {
+    NeuroPoolChunk *const next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  p->item_size = 0U;
+  p->free_list = NULL;
+  p->chunks = NULL;
+  memset(&p->stats, 0, sizeof(NeuroPoolStats));
+}
+
+void *NeuroTypePoolAlloc(NeuroPool *p) {
+  if (!p || p->item_size == 0U)
+    return NULL;
+  if (!p->free_list && !add_pool_chunk(p))
+    return NULL;
+  void **const item = (void **)p->free_list;
+  p->free_list = *item;
+  p->stats.used++;
+  return item;
+}
+
+void NeuroTypePoolFree(NeuroPool *p, void *item) {
+  if (!p || !item)
+    return;
+  *(void **)item = p->free_list;
+  p->free_list = item;
+  p->stats.used--;
+}
+
+void NeuroTypePoolGetStats(const NeuroPool *p, NeuroPoolStats *s) {
+  if (!p || !s)
+    return;
+  memmove(s, &p->stats, sizeof(NeuroPoolStats));
+}
+
+// Init and Stop
+bool NeuroTypeInit(void) {
+  return NeuroTypePoolInit(&client_pool_, sizeof(NeuroClient), CLIENT_POOL_CHUNK_ITEMS) &&
+      NeuroTypePoolInit(&client_info_pool_, sizeof(NeuroClientInfo), CLIENT_POOL_CHUNK_ITEMS) &&
+      grow_string_table();
+}
+
+void NeuroTypeStop(void) {
+  stop_string_table();
+  NeuroTypePoolStop(&client_info_pool_);
+  NeuroTypePoolStop(&client_pool_);
+}
+
+void NeuroTypeGetClientPoolStats(NeuroPoolStats *s) {
+  NeuroTypePoolGetStats(&client_pool_, s);
+}
+
+// Strings
+// NOTE: interned strings live until NeuroTypeStop, so equal strings can be compared by pointer
+const char *NeuroTypeInternString(const char *str) {
+  if (!str || !string_table_)
+    return NULL;
+
+  char **slot = find_string_slot(string_table_, string_table_size_, str);
+  if (*slot)
+    return *slot;
+
+  // Keep the load factor under 1/2
+  if ((string_table_num_ + 1U)*2U > string_table_size_) {
+    if (!grow_string_table())
+      return NULL;
+    slot = find_string_slot(string_table_, string_table_size_, str);
+  }
+
+  const size_t size = strlen(str) + 1U;
+  char *const new_str = (char *)malloc(size);
+  if (!new_str)
+    return NULL;
+  memcpy(new_str, str, size);
+  *slot = new_str;
+  string_table_num_++;
+  return new_str;
+}
+
+
 // Creation and Destruction
 NeuroClient *NeuroTypeNewClient(Window w, const XWindowAttributes *wa) {
-  NeuroClient *const c = (NeuroClient *)malloc(sizeof(NeuroClient));
+  NeuroClient *const c = (NeuroClient *)NeuroTypePoolAlloc(&client_pool_);
   if (!c)
     return NULL;
+  NeuroClientInfo *const info = (NeuroClientInfo *)NeuroTypePoolAlloc(&client_info_pool_);
+  if (!info) {
+    NeuroTypePoolFree(&client_pool_, c);
+    return NULL;
+  }
 
   // Set region
   c->float_region.p.x = wa ? wa->x : 0;
@@ -40,14 +247,25 @@ NeuroClient *NeuroTypeNewClient(Window w, const XWindowAttributes *wa) {
   // Set the properties
   c->ws = 0;
   c->is_nsp = false;
-  c->class[ 0 ] = '\0';
-  c->name[ 0 ] = '\0';
-  c->title[ 0 ] = '\0';
   c->is_fullscreen = false;
   c->free_setter_fn = NeuroRuleFreeSetterNull;
   c->fixed_pos = NEURO_FIXED_POSITION_NULL;
   c->fixed_size = 0;
   c->is_urgent = false;
+  memset(&c->applied, 0, sizeof(NeuroClientApplied));
+
+  // Set the info
+  info->class = NULL;
+  info->name = NULL;
+  info->title = NULL;
+  info->title_size = 0U;
+  memset(&info->size_hints, 0, sizeof(NeuroSizeHints));
+  info->denied_configure_requests = 0U;
+  info->sync_counter = None;
+  info->ignore_unmaps = 0U;
+  info->net_states_size = 0U;
+  info->net_state_serial = 0UL;
+  c->info = info;
 
   return c;
 }
@@ -55,10 +273,88 @@ NeuroClient *NeuroTypeNewClient(Window w, const XWindowAttributes *wa) {
 void NeuroTypeDeleteClient(NeuroClient *c) {
   if (!c)
     return;
-  free(c);
+  free(c->info->title);
+  NeuroTypePoolFree(&client_info_pool_, c->info);
+  NeuroTypePoolFree(&client_pool_, c);
   c = NULL;
 }
 
+// Client Info
+bool NeuroTypeSetClientTitle(NeuroClient *c, const char *title) {
+  if (!c || !title)
+    return false;
+
+  // Grow the title buffer only when the new title does not fit
+  NeuroClientInfo *const info = c->info;
+  const size_t size = strlen(title) + 1U;
+  if (size > info->title_size) {
+    size_t new_size = info->title_size ? info->title_size : TITLE_MIN_SIZE;
+    while (new_size < size)
+      new_size *= 2U;
+    char *const new_title = (char *)realloc(info->title, new_size);
+    if (!new_title)
+      return false;
+    info->title = new_title;
+    info->title_size = new_size;
+  }
+
+  memcpy(info->title, title, size);
+  return true;
+}
+
+const char *NeuroTypeGetClientTitle(const NeuroClient *c) {
+  if (!c || !c->info->title)
+    return "";
+  return c->info->title;
+}
+
+// Same defaults as ICCCM 4.1.2.3, base and minimum size stand in for each other
+void NeuroTypeSetClientSizeHints(NeuroClient *c, const XSizeHints *sh) {
+  if (!c || !sh)
+    return;
+  NeuroSizeHints *const h = &c->info->size_hints;
+  memset(h, 0, sizeof(NeuroSizeHints));
+  if (sh->flags & PBaseSize) {
+    h->base_w = sh->base_width;
+    h->base_h = sh->base_height;
+  } else if (sh->flags & PMinSize) {
+    h->base_w = sh->min_width;
+    h->base_h = sh->min_height;
+  }
+  if (sh->flags & PMinSize) {
+    h->min_w = sh->min_width;
+    h->min_h = sh->min_height;
+  } else if (sh->flags & PBaseSize) {
+    h->min_w = sh->base_width;
+    h->min_h = sh->base_height;
+  }
+  if (sh->flags & PMaxSize) {
+    h->max_w = sh->max_width;
+    h->max_h = sh->max_height;
+  }
+  if (sh->flags & PResizeInc) {
+    h->inc_w = sh->width_inc;
+    h->inc_h = sh->height_inc;
+  }
+  if ((sh->flags & PAspect) && sh->min_aspect.x > 0 && sh->max_aspect.y > 0) {
+    h->min_aspect = (float)sh->min_aspect.y / (float)sh->min_aspect.x;
+    h->max_aspect = (float)sh->max_aspect.x / (float)sh->max_aspect.y;
+  }
+}
+
+// Only the fullscreen and hidden states are owned by neurowm, the rest are kept when it rewrites _NET_WM_STATE
+void NeuroTypeSetClientNetStates(NeuroClient *c, const Atom *states, NeuroIndex n) {
+  if (!c || (!states && n > 0U))
+    return;
+  const Atom fullscreen = NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_FULLSCREEN);
+  const Atom hidden = NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_HIDDEN);
+  NeuroClientInfo *const info = c->info;
+  info->net_states_size = 0U;
+  for (NeuroIndex i = 0U; i < n && info->net_states_size < NEURO_NET_STATES_MAX; ++i)
+    if (states[ i ] != fullscreen && states[ i ] != hidden)
+      info->net_states[ info->net_states_size++ ] = states[ i ];
+}
+
 // Basic Functions
 NeuroIndex NeuroTypeArrayLength(const void *const *array_ptr) {
   if (!array_ptr)
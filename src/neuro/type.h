@@ -17,6 +17,14 @@
 #ifdef XRANDR
   #include <X11/extensions/Xrandr.h>
 #endif
+#ifdef XCB
+  #include <X11/Xlib-xcb.h>
+  #include <xcb/xcb.h>
+#endif
+#ifdef XSYNC
+  #include <X11/Xlib.h>
+  #include <X11/extensions/sync.h>
+#endif
 
 // Includes
 #include <X11/keysym.h>
@@ -90,6 +98,7 @@
 // Default sizes
 #define NEURO_NAME_SIZE_MAX    256
 #define NEURO_ARRANGE_ARGS_MAX 4
+#define NEURO_NET_STATES_MAX   16
 
 // Reload
 #define NEURO_EXIT_RELOAD ((int)'R')
@@ -112,7 +121,9 @@ enum NeuroLayoutMod {
   NEURO_LAYOUT_MOD_NULL = 0,
   NEURO_LAYOUT_MOD_MIRROR = 1 << 0,
   NEURO_LAYOUT_MOD_REFLECTX = 1 << 1,
-  NEURO_LAYOUT_MOD_REFLECTY = 1 << 2
+  NEURO_LAYOUT_MOD_REFLECTY = 1 << 2,
+  NEURO_LAYOUT_MOD_SIZEHINTS = 1 << 3,  // Apply the size hints of clients, e.g. resize increments (opt-in)
+  NEURO_LAYOUT_MOD_OUTLINE = 1 << 4  // Resize clients drawing an outline, configuring them once on release
 };
 typedef enum NeuroLayoutMod NeuroLayoutMod;
 
@@ -126,6 +137,16 @@ enum NeuroFixedPosition {
 };
 typedef enum NeuroFixedPosition NeuroFixedPosition;
 
+// NeuroClientFlag (client properties that the stacks keep track of)
+enum NeuroClientFlag {
+  NEURO_CLIENT_FLAG_URGENT = 0,
+  NEURO_CLIENT_FLAG_FIXED,
+  NEURO_CLIENT_FLAG_FULLSCREEN,
+  NEURO_CLIENT_FLAG_FREE,
+  NEURO_CLIENT_FLAG_END
+};
+typedef enum NeuroClientFlag NeuroClientFlag;
+
 
 // INDEX TYPES ---------------------------------------------------------------------------------------------------------
 
@@ -133,6 +154,31 @@ typedef enum NeuroFixedPosition NeuroFixedPosition;
 typedef size_t NeuroIndex;
 
 
+// POOL TYPES ----------------------------------------------------------------------------------------------------------
+
+// NeuroPoolChunk (Forward declaration)
+typedef struct NeuroPoolChunk NeuroPoolChunk;
+
+// NeuroPoolStats
+struct NeuroPoolStats {
+  NeuroIndex used;        // Number of items handed out
+  NeuroIndex capacity;    // Number of items the allocated chunks can hold
+  NeuroIndex chunks;      // Number of allocated chunks
+  NeuroIndex heap_calls;  // Number of heap allocations and deallocations done by the pool
+};
+typedef struct NeuroPoolStats NeuroPoolStats;
+
+// NeuroPool (fixed-size slab allocator)
+struct NeuroPool {
+  size_t item_size;         // Size of each item, rounded up to the item alignment
+  NeuroIndex chunk_items;   // Number of items each chunk holds
+  void *free_list;          // Singly-linked list of free items
+  NeuroPoolChunk *chunks;   // Singly-linked list of allocated chunks
+  NeuroPoolStats stats;
+};
+typedef struct NeuroPool NeuroPool;
+
+
 // GEOMETRY TYPES ------------------------------------------------------------------------------------------------------
 
 // NeuroPoint
@@ -150,26 +196,84 @@ struct NeuroRectangle {
 };
 typedef struct NeuroRectangle NeuroRectangle;
 
+// NeuroSizeHints (WM_NORMAL_HINTS of a window, 0 if not set)
+struct NeuroSizeHints {
+  int base_w;        // Base width
+  int base_h;        // Base height
+  int min_w;         // Minimum width
+  int min_h;         // Minimum height
+  int max_w;         // Maximum width
+  int max_h;         // Maximum height
+  int inc_w;         // Width increment
+  int inc_h;         // Height increment
+  float min_aspect;  // Minimum height/width ratio
+  float max_aspect;  // Maximum width/height ratio
+};
+typedef struct NeuroSizeHints NeuroSizeHints;
+
+// NeuroDirection
+enum NeuroDirection {
+  NEURO_DIRECTION_UP = 0,
+  NEURO_DIRECTION_DOWN,
+  NEURO_DIRECTION_LEFT,
+  NEURO_DIRECTION_RIGHT,
+  NEURO_DIRECTION_END
+};
+typedef enum NeuroDirection NeuroDirection;
+
 // NeuroFreeSetterFn
 typedef void (*NeuroFreeSetterFn)(NeuroRectangle *a, const NeuroRectangle *r);
 
 
 // CLIENT TYPES --------------------------------------------------------------------------------------------------------
 
-// NeuroClient
+// NeuroClientApplied (window state last sent to the X server)
+struct NeuroClientApplied {
+  NeuroRectangle region;
+  int border_width;
+  unsigned long border_color;
+  bool is_region_valid;
+  bool is_border_width_valid;
+  bool is_border_color_valid;
+  bool is_buttons_grabbed;  // Whether all buttons are grabbed or the ones ungrabbed on focus are not
+  bool is_buttons_grab_valid;
+  bool is_mapped;
+  bool is_map_valid;
+  bool is_net_fullscreen;  // _NET_WM_STATE_FULLSCREEN is in _NET_WM_STATE
+  bool is_net_hidden;      // _NET_WM_STATE_HIDDEN is in _NET_WM_STATE
+  bool is_net_state_valid;
+};
+typedef struct NeuroClientApplied NeuroClientApplied;
+
+// NeuroClientInfo (cold part of a client, not touched by layouts and queries)
+struct NeuroClientInfo {
+  const char *class;  // Interned, NULL if unknown
+  const char *name;   // Interned, NULL if unknown
+  char *title;        // NULL until the client gets a title
+  size_t title_size;  // Allocated size of the title buffer
+  NeuroSizeHints size_hints;
+  NeuroIndex denied_configure_requests;  // Configure requests answered with the current geometry
+  XID sync_counter;   // _NET_WM_SYNC_REQUEST_COUNTER, None if the client does not support it
+  NeuroIndex ignore_unmaps;  // UnmapNotify events caused by neurowm, which do not withdraw the window
+  Atom net_states[ NEURO_NET_STATES_MAX ];  // _NET_WM_STATE atoms not owned by neurowm
+  NeuroIndex net_states_size;
+  unsigned long net_state_serial;  // Serial of the last _NET_WM_STATE change sent by neurowm
+};
+typedef struct NeuroClientInfo NeuroClientInfo;
+
+// NeuroClient (hot part of a client, read by layouts, queries and every update)
 struct NeuroClient {
-  NeuroRectangle float_region;
+  NeuroRectangle float_region;  // Only while not in a stack, the stack keeps it then (NeuroCoreClientGetFloatRegion)
   Window win;
   NeuroIndex ws;
-  bool is_nsp;
-  char class[ NEURO_NAME_SIZE_MAX ];
-  char name[ NEURO_NAME_SIZE_MAX ];
-  char title[ NEURO_NAME_SIZE_MAX ];
-  bool is_fullscreen;
   NeuroFreeSetterFn free_setter_fn;
-  NeuroFixedPosition fixed_pos;
+  NeuroClientInfo *info;
   float fixed_size;
+  NeuroFixedPosition fixed_pos;
+  bool is_nsp;
+  bool is_fullscreen;
   bool is_urgent;
+  NeuroClientApplied applied;
 };
 typedef struct NeuroClient NeuroClient;
 
@@ -182,6 +286,13 @@ typedef bool (*NeuroClientTesterFn)(NeuroClientPtrPtr c, const void *p);
 // NeuroClientSelectorFn
 typedef NeuroClientPtrPtr (*NeuroClientSelectorFn)(NeuroClientPtrPtr c);
 
+// NeuroClientDragArg (argument of the interactive move and resize functions)
+struct NeuroClientDragArg {
+  const NeuroPoint *pointer;   // Root coordinates of the pointer when the drag starts, NULL to ask the X server
+  const void *free_setter_fn;  // Only for free moves and resizes, see NeuroClientFree
+};
+typedef struct NeuroClientDragArg NeuroClientDragArg;
+
 
 // DZEN TYPES ----------------------------------------------------------------------------------------------------------
 
@@ -249,6 +360,7 @@ struct NeuroMonitor {
   NeuroIndex default_ws;
   const int *gaps;
   NeuroRectangle region;  // The region does not include the gaps (region + gaps = total_monitor_area)
+  int refresh_rate;  // In Hz
   const NeuroDzenPanel *const *dzen_panel_list;
 };
 typedef struct NeuroMonitor NeuroMonitor;
@@ -316,6 +428,14 @@ struct NeuroActionChain {
 };
 typedef struct NeuroActionChain NeuroActionChain;
 
+// NeuroActionContext (state of the event that triggered an action chain)
+struct NeuroActionContext {
+  NeuroPoint pointer;  // Root coordinates of the pointer
+  Window window;       // Top-level window under the pointer, None if it is the root window
+  Time time;
+};
+typedef struct NeuroActionContext NeuroActionContext;
+
 
 // LAYOUT TYPES --------------------------------------------------------------------------------------------------------
 
@@ -332,8 +452,8 @@ typedef int (*NeuroBorderSetterFn)(NeuroClientPtrPtr c);
 struct NeuroArrange {
   NeuroIndex size;                        // Number of tiled clients
   NeuroRectangle region;                  // Tiled layout region
-  NeuroRectangle **client_regions;        // Region of each client
-  NeuroRectangle **client_float_regions;  // Float region of each client
+  NeuroRectangle *client_regions;         // Region of each client, contiguous
+  NeuroRectangle *client_float_regions;   // Float region of each client, contiguous
   NeuroArg *parameters;                   // Parameters of the arrange
 };
 typedef struct NeuroArrange NeuroArrange;
@@ -436,10 +556,31 @@ typedef struct NeuroConfiguration NeuroConfiguration;
 // PUBLIC FUNCTION DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Pool
+bool NeuroTypePoolInit(NeuroPool *p, size_t item_size, NeuroIndex chunk_items);
+void NeuroTypePoolStop(NeuroPool *p);
+void *NeuroTypePoolAlloc(NeuroPool *p);
+void NeuroTypePoolFree(NeuroPool *p, void *item);
+void NeuroTypePoolGetStats(const NeuroPool *p, NeuroPoolStats *s);
+
+// Init and Stop
+bool NeuroTypeInit(void);
+void NeuroTypeStop(void);
+void NeuroTypeGetClientPoolStats(NeuroPoolStats *s);
+
+// Strings
+const char *NeuroTypeInternString(const char *str);
+
 // Creation and Destruction
 NeuroClient *NeuroTypeNewClient(Window w, const XWindowAttributes *wa);
 void NeuroTypeDeleteClient(NeuroClient *c);
 
+// Client Info
+bool NeuroTypeSetClientTitle(NeuroClient *c, const char *title);
+const char *NeuroTypeGetClientTitle(const NeuroClient *c);
+void NeuroTypeSetClientSizeHints(NeuroClient *c, const XSizeHints *sh);
+void NeuroTypeSetClientNetStates(NeuroClient *c, const Atom *states, NeuroIndex n);
+
 // Basic Functions
 NeuroIndex NeuroTypeArrayLength(const void *const *array_ptr);
 
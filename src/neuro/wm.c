@@ -16,15 +16,20 @@
 #include "system.h"
 #include "config.h"
 #include "core.h"
+#include "rule.h"
 #include "event.h"
 #include "dzen.h"
 
+// Defines
+#define EVENT_BATCH_SIZE 256
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE VARIABLE DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
 
 static bool stop_main_while_ = false;
+static XEvent events_[ EVENT_BATCH_SIZE ];
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -36,8 +41,11 @@ static bool recompile_wm(pid_t *pid) {
 }
 
 static void stop_wm(void) {
-  NeuroActionRunActionChain(&NeuroConfigGet()->stop_action_chain);
+  NeuroActionRunActionChain(&NeuroConfigGet()->stop_action_chain, NULL);
   NeuroDzenStop();
+  NeuroEventUnloadWindows();
+  NeuroEventStop();
+  NeuroRuleStop();
   NeuroCoreStop();
   NeuroMonitorStop();
   NeuroSystemStop();
@@ -58,13 +66,17 @@ static void init_wm(const NeuroConfiguration *c) {
   // Set the configuration
   NeuroConfigSet(c);
 
-  // Init System, NeuroMonitor, Core and Panels
+  // Init System, NeuroMonitor, Core, Rules, Events and Panels
   if (!NeuroSystemInit())
     NeuroSystemError(__func__, "Could not init System module");
   if (!NeuroMonitorInit())
     NeuroSystemError(__func__, "Could not init Monitor module");
   if (!NeuroCoreInit())
     NeuroSystemError(__func__, "Could not init Core module");
+  if (!NeuroRuleInit())
+    NeuroSystemError(__func__, "Could not init Rule module");
+  if (!NeuroEventInit())
+    NeuroSystemError(__func__, "Could not init Event module");
   if (!NeuroDzenInit())
     NeuroSystemError(__func__, "Could not init Dzen module");
 
@@ -72,7 +84,7 @@ static void init_wm(const NeuroConfiguration *c) {
   NeuroWorkspaceChange(NeuroMonitorSelectorHead(NULL)->default_ws);
 
   // Run the init action chain
-  NeuroActionRunActionChain(&NeuroConfigGet()->init_action_chain);
+  NeuroActionRunActionChain(&NeuroConfigGet()->init_action_chain, NULL);
 
   // Catch asynchronously SIGUSR1
   // if (SIG_ERR == signal(SIGUSR1, wm_signal_handler))
@@ -91,12 +103,13 @@ int NeuroWmRun(const NeuroConfiguration *c) {
   // Init window manager
   init_wm(c);
 
-  // Main loop
-  XEvent ev;
-  while (!stop_main_while_ && !XNextEvent(NeuroSystemGetDisplay(), &ev)) {
-    const NeuroEventHandlerFn eh = NeuroEventGetHandler(ev.type);
-    if (eh)
-      eh(&ev);
+  // Main loop, it waits for an event and then drains all the pending ones to handle them as a batch
+  Display *const display = NeuroSystemGetDisplay();
+  while (!stop_main_while_ && !XNextEvent(display, events_)) {
+    NeuroIndex n = 1U;
+    while (n < EVENT_BATCH_SIZE && XPending(display))
+      XNextEvent(display, events_ + n++);
+    NeuroEventHandleBatch(events_, n);
   }
 
   // Stop window manager
@@ -42,7 +42,7 @@ static void focus_client(NeuroClientPtrPtr c) {
   assert(c);
   NeuroClientUnsetUrgent(c, NULL);
   const Window win = NEURO_CLIENT_PTR(c)->win;
-  NeuroSystemUngrabButtons(win, NeuroConfigGet()->button_list);
+  NeuroClientUngrabButtons(c, NULL);
   XSetInputFocus(NeuroSystemGetDisplay(), win, RevertToPointerRoot, CurrentTime);
   XChangeProperty(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_ACTIVE),
       XA_WINDOW, 32, PropModeReplace, (const unsigned char *)&(win), 1);
@@ -50,7 +50,57 @@ static void focus_client(NeuroClientPtrPtr c) {
 
 static void unfocus_client(NeuroClientPtrPtr c) {
   assert(c);
-  NeuroSystemGrabButtons(NEURO_CLIENT_PTR(c)->win, NeuroConfigGet()->button_list);
+  NeuroClientGrabButtons(c, NULL);
+}
+
+// Whether the stacking order cs2 is cs1 with only the client c moved
+static bool is_only_client_moved(const NeuroClientPtrPtr *cs1, const NeuroClientPtrPtr *cs2, NeuroIndex n,
+    const NeuroClientPtrPtr c) {
+  assert(cs1);
+  assert(cs2);
+  NeuroIndex j = 0U;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    if (cs1[ i ] == c)
+      continue;
+    if (cs2[ j ] == c)
+      ++j;
+    if (cs1[ i ] != cs2[ j ])
+      return false;
+    ++j;
+  }
+  return true;
+}
+
+// Restacks the windows from the stacking order of the stack (old) to the new one, top first, sending the least requests
+static void restack_clients(NeuroIndex ws, const NeuroClientPtrPtr *old, const NeuroClientPtrPtr *new, NeuroIndex n,
+    const NeuroClientPtrPtr c) {
+  assert(old);
+  assert(new);
+  assert(c);
+  const bool is_dirty = NeuroCoreStackIsStackingDirty(ws);
+  if (!is_dirty && !memcmp(old, new, n*sizeof(NeuroClientPtrPtr)))
+    return;
+
+  if (!is_dirty && n > 1U && is_only_client_moved(old, new, n, c)) {
+    // Place the moved client next to its new neighbour
+    NeuroIndex i = 0U;
+    while (new[ i ] != c)
+      ++i;
+    XWindowChanges wc;
+    wc.sibling = NEURO_CLIENT_PTR(new[ i > 0U ? i - 1U : 1U ])->win;
+    wc.stack_mode = i > 0U ? Below : Above;
+    XConfigureWindow(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win, CWSibling | CWStackMode, &wc);
+  } else {
+    Window windows[ n ];
+    for (NeuroIndex i = 0U; i < n; ++i)
+      windows[ i ] = NEURO_CLIENT_PTR(new[ i ])->win;
+    XRestackWindows(NeuroSystemGetDisplay(), windows, n);
+  }
+
+  // Update the stacking order of the stack
+  for (NeuroIndex i = n; i > 0U; --i)
+    NeuroCoreClientRaise(new[ i - 1U ]);
+  NeuroCoreStackSetStackingDirty(ws, false);
 }
 
 static void process_client(const WorkspaceClientFn wcf, const NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf,
@@ -74,14 +124,8 @@ static void send_client(NeuroClientPtrPtr c, const void *data) {
   if (old_ws == new_ws)
     return;
 
-  // Remove the client from its stack
-  NeuroClient *const cli = NeuroCoreRemoveClient(c);
-
-  // Add the client to the new stack
-  cli->ws = new_ws;
-  const NeuroClientPtrPtr c2 = NeuroCoreAddClientStart(cli);
-  if (!c2)
-    NeuroSystemError(__func__, "Could not add client");
+  // Move the client to the new stack
+  NeuroCoreMoveClient(c, new_ws);
 
   // Update old and new workspaces
   NeuroLayoutRunCurr(curr_ws);
@@ -108,10 +152,12 @@ void NeuroWorkspaceChange(NeuroIndex ws) {
   NeuroCoreStackSetMonitor(curr, new_monitor);
   NeuroCoreStackSetMonitor(ws, curr_monitor);
 
-  // Update old and new workspaces
-  NeuroLayoutRunCurr(curr);
+  // Update old and new workspaces, only arranging the ones that changed while hidden or got another monitor
+  if (NeuroCoreStackIsLayoutDirty(curr))
+    NeuroLayoutRunCurr(curr);
   NeuroWorkspaceUpdate(curr);
-  NeuroLayoutRunCurr(ws);
+  if (NeuroCoreStackIsLayoutDirty(ws))
+    NeuroLayoutRunCurr(ws);
   NeuroWorkspaceUpdate(ws);
 
   // Focus the current workspace
@@ -120,51 +166,44 @@ void NeuroWorkspaceChange(NeuroIndex ws) {
   NeuroWorkspaceFocus(ws);
 }
 
+// The clients of a hidden stack are only unmapped, which sends nothing to the X server for the ones already unmapped
 void NeuroWorkspaceUpdate(NeuroIndex ws) {
   for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
     NeuroClientUpdate(c, NULL);
 }
 
 void NeuroWorkspaceFocus(NeuroIndex ws) {
-  NeuroIndex n = NeuroCoreStackGetSize(ws);
+  const NeuroIndex n = NeuroCoreStackGetSize(ws);
   if (n == 0) {
     XDeleteProperty(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_ACTIVE));
     return;
   }
 
-  Window windows[ n ], d1, d2, *wins = NULL;
-  NeuroIndex atc = 0U;
-  NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws);
-  for ( ; c; c = NeuroCoreClientGetNext(c))
+  // Get the current stacking order and focus the current client
+  NeuroClientPtrPtr old[ n ], new[ n ];
+  NeuroIndex atc = 0U, i = 0U;
+  const NeuroClientPtrPtr curr = NeuroCoreStackGetCurrClient(ws);
+  for (NeuroClientPtrPtr c = NeuroCoreStackGetTopClient(ws); c; c = NeuroCoreClientGetBelow(c)) {
+    old[ i++ ] = c;
     if (is_above_tiled_client(c))
       ++atc;
-
-  c = NeuroCoreStackGetCurrClient(ws);
-  windows[ is_above_tiled_client(c) ? 0U : atc ] = NEURO_CLIENT_PTR(c)->win;
-  focus_client(c);
-  NeuroClientUpdate(c, NULL);
-
-  if (n > 1) {
-    // XQueryTree gets windows by stacking order
-    unsigned int num = 0U;
-    if (!XQueryTree(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), &d1, &d2, &wins, &num))
-      NeuroSystemError(__func__, "Could not get windows");
-    NeuroIndex n2 = n;
-    for (unsigned int i = 0U; i < num; ++i) {
-      c = NeuroWorkspaceClientFindWindow(ws, wins[ i ]);
-      if (!c)
-        continue;
-      if (NeuroCoreClientIsCurr(c))
-        continue;
-      windows[ is_above_tiled_client(c) ? --atc : --n2 ] = NEURO_CLIENT_PTR(c)->win;
-      unfocus_client(c);
-      NeuroClientUpdate(c, NULL);
-    }
-    if (wins)
-      XFree(wins);
+    if (c == curr)
+      continue;
+    unfocus_client(c);
+    NeuroClientUpdate(c, NULL);
   }
+  assert(i == n);
+  focus_client(curr);
+  NeuroClientUpdate(curr, NULL);
+
+  // The current client goes on top of its band, above tiled clients over tiled ones, the rest keep their order
+  NeuroIndex above = 0U, tiled = atc;
+  new[ is_above_tiled_client(curr) ? above++ : tiled++ ] = curr;
+  for (i = 0U; i < n; ++i)
+    if (old[ i ] != curr)
+      new[ is_above_tiled_client(old[ i ]) ? above++ : tiled++ ] = old[ i ];
 
-  XRestackWindows(NeuroSystemGetDisplay(), windows, n);
+  restack_clients(ws, old, new, n, curr);
 }
 
 void NeuroWorkspaceUnfocus(NeuroIndex ws) {
@@ -202,34 +241,22 @@ void NeuroWorkspaceRestoreLastMinimized(NeuroIndex ws) {
   NeuroWorkspaceFocus(win);
 }
 
-void NeuroWorkspaceAddEnterNotifyMask(NeuroIndex ws) {
-  NeuroClientPtrPtr c;
-  for (c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
-    XSelectInput(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win, NEURO_SYSTEM_CLIENT_MASK);
-}
-
-void NeuroWorkspaceRemoveEnterNotifyMask(NeuroIndex ws) {
-  NeuroClientPtrPtr c;
-  for (c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
-    XSelectInput(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win, NEURO_SYSTEM_CLIENT_MASK_NO_ENTER);
-}
-
 // Find functions
 NeuroClientPtrPtr NeuroWorkspaceClientFindWindow(NeuroIndex ws, Window w) {
-  return NeuroCoreStackFindClient(ws, NeuroClientTesterWindow, (const void *)&w);
+  return NeuroCoreStackFindWindowClient(ws, w);
 }
 
 NeuroClientPtrPtr NeuroWorkspaceClientFindUrgent(NeuroIndex ws) {
-  return NeuroCoreStackFindClient(ws, NeuroClientTesterUrgent, NULL);
+  return NeuroCoreStackGetFlagClient(ws, NEURO_CLIENT_FLAG_URGENT);
 }
 
 NeuroClientPtrPtr NeuroWorkspaceClientFindFixed(NeuroIndex ws) {
-  return NeuroCoreStackFindClient(ws, NeuroClientTesterFixed, NULL);
+  return NeuroCoreStackGetFlagClient(ws, NEURO_CLIENT_FLAG_FIXED);
 }
 
-// Note: This might return a lower window in the stacking order
+// Returns the topmost client in the stacking order of the workspace
 NeuroClientPtrPtr NeuroWorkspaceClientFindPointed(NeuroIndex ws, const NeuroPoint *p) {
-  return NeuroCoreStackFindClient(ws, NeuroClientTesterPointed, (const void *)p);
+  return NeuroCoreStackFindPointedClient(ws, p);
 }
 
 NeuroClientPtrPtr NeuroWorkspaceClientFindHidden(NeuroIndex ws) {
@@ -301,20 +328,20 @@ void NeuroWorkspaceClientToggleFullscreen(const NeuroClientPtrPtr ref, const Neu
   process_client(NeuroClientToggleFullscreen, ref, csf, data);
 }
 
-void NeuroWorkspaceClientFloatMove(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data) {
-  process_client(NeuroClientFloatMove, ref, csf, data);
+void NeuroWorkspaceClientFloatMove(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *drag_arg) {
+  process_client(NeuroClientFloatMove, ref, csf, drag_arg);
 }
 
-void NeuroWorkspaceClientFloatResize(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data) {
-  process_client(NeuroClientFloatResize, ref, csf, data);
+void NeuroWorkspaceClientFloatResize(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *drag_arg) {
+  process_client(NeuroClientFloatResize, ref, csf, drag_arg);
 }
 
-void NeuroWorkspaceClientFreeMove(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data) {
-  process_client(NeuroClientFreeMove, ref, csf, data);
+void NeuroWorkspaceClientFreeDragMove(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *drag_arg) {
+  process_client(NeuroClientFreeDragMove, ref, csf, drag_arg);
 }
 
-void NeuroWorkspaceClientFreeResize(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data) {
-  process_client(NeuroClientFreeResize, ref, csf, data);
+void NeuroWorkspaceClientFreeDragResize(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *drag_arg) {
+  process_client(NeuroClientFreeDragResize, ref, csf, drag_arg);
 }
 
 // NeuroWorkspace Selectors
@@ -30,8 +30,6 @@ void NeuroWorkspaceTile(NeuroIndex ws);
 void NeuroWorkspaceFree(NeuroIndex ws, const void *free_setter_fn);
 void NeuroWorkspaceMinimize(NeuroIndex ws);
 void NeuroWorkspaceRestoreLastMinimized(NeuroIndex ws);
-void NeuroWorkspaceAddEnterNotifyMask(NeuroIndex ws);
-void NeuroWorkspaceRemoveEnterNotifyMask(NeuroIndex ws);
 
 // Find
 NeuroClientPtrPtr NeuroWorkspaceClientFindWindow(NeuroIndex ws, Window w);
@@ -52,10 +50,10 @@ void NeuroWorkspaceClientToggleFree(NeuroClientPtrPtr ref, const NeuroClientSele
 void NeuroWorkspaceClientNormal(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data);
 void NeuroWorkspaceClientFullscreen(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data);
 void NeuroWorkspaceClientToggleFullscreen(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data);
-void NeuroWorkspaceClientFloatMove(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data);
-void NeuroWorkspaceClientFloatResize(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data);
-void NeuroWorkspaceClientFreeMove(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data);
-void NeuroWorkspaceClientFreeResize(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *data);
+void NeuroWorkspaceClientFloatMove(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *drag_arg);
+void NeuroWorkspaceClientFloatResize(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *drag_arg);
+void NeuroWorkspaceClientFreeDragMove(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *drag_arg);
+void NeuroWorkspaceClientFreeDragResize(NeuroClientPtrPtr ref, const NeuroClientSelectorFn csf, const void *drag_arg);
 
 // NeuroWorkspace Selectors
 NeuroIndex NeuroWorkspaceSelector0(void);
@@ -16,6 +16,9 @@
 #include <BCUnit/Basic.h>
 #include "../neuro/system.h"
 #include "../neuro/core.h"
+#include "../neuro/rule.h"
+#include "../neuro/geometry.h"
+#include "../neuro/layout.h"
 #include "../neuro/wm.h"
 
 
@@ -58,6 +61,361 @@ static void add_remove_client(void) {
   NeuroTypeDeleteClient(cli2);
 }
 
+static void find_window_client(void) {
+  // Create some fake clients
+  NeuroClient *const cli1 = NeuroTypeNewClient(1UL, NULL);
+  NeuroClient *const cli2 = NeuroTypeNewClient(2UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli1);
+  CU_ASSERT_PTR_NOT_NULL(cli2);
+
+  // Add them to the stack list and find them by window
+  NeuroClientPtrPtr c1 = NeuroCoreAddClientStart(cli1);
+  NeuroClientPtrPtr c2 = NeuroCoreAddClientStart(cli2);
+  CU_ASSERT(NeuroCoreFindWindowClient(1UL) == c1);
+  CU_ASSERT(NeuroCoreFindWindowClient(2UL) == c2);
+  CU_ASSERT_PTR_NULL(NeuroCoreFindWindowClient(3UL));
+
+  // Swapped clients must be found in their new nodes
+  NeuroCoreClientSwap(c1, c2);
+  CU_ASSERT(NeuroCoreFindWindowClient(1UL) == c2);
+  CU_ASSERT(NeuroCoreFindWindowClient(2UL) == c1);
+
+  // Minimized clients are not tiled, but they can be removed by window
+  NeuroClient *const cli3 = NeuroCoreRemoveClient(NeuroCoreFindWindowClient(1UL));
+  CU_ASSERT(cli3 == cli1);
+  CU_ASSERT(NeuroCorePushMinimizedClient(cli3) == cli1);
+  CU_ASSERT_PTR_NULL(NeuroCoreFindWindowClient(1UL));
+  CU_ASSERT(NeuroCoreRemoveMinimizedClient(1UL) == cli1);
+  CU_ASSERT_PTR_NULL(NeuroCoreRemoveMinimizedClient(1UL));
+
+  // Free the fake clients
+  NeuroTypeDeleteClient(cli1);
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(NeuroCoreFindWindowClient(2UL)));
+  CU_ASSERT_PTR_NULL(NeuroCoreFindWindowClient(2UL));
+}
+
+static void move_client_pool(void) {
+  // Create a fake client
+  NeuroClient *const cli = NeuroTypeNewClient(4UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  CU_ASSERT_PTR_NOT_NULL(c);
+  NeuroPoolStats node_stats, client_stats;
+  NeuroCoreGetPoolStats(&node_stats, &client_stats);
+  CU_ASSERT(node_stats.used == 1U);
+  CU_ASSERT(client_stats.used == 1U);
+
+  // Moving the client relinks the same node
+  CU_ASSERT(NeuroCoreMoveClient(c, 1U) == c);
+  CU_ASSERT(cli->ws == 1U);
+  CU_ASSERT(NeuroCoreStackGetHeadClient(1U) == c);
+  CU_ASSERT(NeuroCoreStackFindWindowClient(1U, 4UL) == c);
+  CU_ASSERT(NeuroCoreStackIsEmpty(0U));
+
+  // Minimizing, restoring and moving again must not touch the heap
+  CU_ASSERT(NeuroCorePushMinimizedClient(NeuroCoreRemoveClient(c)) == cli);
+  CU_ASSERT(NeuroCorePopMinimizedClient(1U) == cli);
+  c = NeuroCoreAddClientEnd(cli);
+  CU_ASSERT(NeuroCoreMoveClient(c, 0U) == c);
+  NeuroPoolStats node_stats2, client_stats2;
+  NeuroCoreGetPoolStats(&node_stats2, &client_stats2);
+  CU_ASSERT(node_stats2.used == 1U);
+  CU_ASSERT(node_stats2.heap_calls == node_stats.heap_calls);
+  CU_ASSERT(client_stats2.heap_calls == client_stats.heap_calls);
+
+  // Free the fake client
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+  NeuroCoreGetPoolStats(&node_stats2, &client_stats2);
+  CU_ASSERT(node_stats2.used == 0U);
+  CU_ASSERT(client_stats2.used == 0U);
+}
+
+static void client_info(void) {
+  // Equal strings are interned once
+  char buf[ 16 ];
+  snprintf(buf, sizeof(buf), "%s", "Firefox");
+  const char *const class = NeuroTypeInternString("Firefox");
+  CU_ASSERT_PTR_NOT_NULL(class);
+  CU_ASSERT(NeuroTypeInternString(buf) == class);
+  CU_ASSERT(NeuroTypeInternString("firefox") != class);
+
+  // Titles start empty and only grow when needed
+  NeuroClient *const cli = NeuroTypeNewClient(5UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  CU_ASSERT_STRING_EQUAL(NeuroTypeGetClientTitle(cli), "");
+  CU_ASSERT(NeuroTypeSetClientTitle(cli, "a long enough title to grow the buffer"));
+  const char *const title = NeuroTypeGetClientTitle(cli);
+  CU_ASSERT(NeuroTypeSetClientTitle(cli, "short"));
+  CU_ASSERT(NeuroTypeGetClientTitle(cli) == title);
+  CU_ASSERT_STRING_EQUAL(title, "short");
+
+  // The map state is unknown until the window is managed, and no unmap is ignored
+  CU_ASSERT(!cli->applied.is_map_valid);
+  CU_ASSERT(cli->info->ignore_unmaps == 0U);
+
+  // Other _NET_WM_STATE atoms are kept up to the cache size
+  Atom states[ NEURO_NET_STATES_MAX + 4 ];
+  for (NeuroIndex i = 0U; i < NEURO_NET_STATES_MAX + 4; ++i)
+    states[ i ] = (Atom)(1000U + i);
+  CU_ASSERT(cli->info->net_states_size == 0U);
+  NeuroTypeSetClientNetStates(cli, states, 2U);
+  CU_ASSERT(cli->info->net_states_size == 2U && cli->info->net_states[ 1 ] == 1001U);
+  NeuroTypeSetClientNetStates(cli, states, NEURO_NET_STATES_MAX + 4);
+  CU_ASSERT(cli->info->net_states_size == NEURO_NET_STATES_MAX);
+  NeuroTypeDeleteClient(cli);
+}
+
+static void size_hints(void) {
+  // Terminal like hints: 2px base, 7x14 cells
+  XSizeHints xsh;
+  memset(&xsh, 0, sizeof(XSizeHints));
+  xsh.flags = PBaseSize | PMinSize | PResizeInc;
+  xsh.base_width = xsh.base_height = 2;
+  xsh.min_width = xsh.min_height = 16;
+  xsh.width_inc = 7;
+  xsh.height_inc = 14;
+  NeuroClient *const cli = NeuroTypeNewClient(9UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  NeuroTypeSetClientSizeHints(cli, &xsh);
+  NeuroRectangle r = { { 10, 20 }, 500, 300 };
+  NeuroGeometryRectangleSetSizeHints(&r, &cli->info->size_hints);
+  CU_ASSERT(r.p.x == 10 && r.p.y == 20);
+  CU_ASSERT(r.w == 2 + 71*7 && r.h == 2 + 21*14);
+
+  // Sizes are never increased over the given region
+  NeuroRectangle small = { { 0, 0 }, 8, 8 };
+  NeuroGeometryRectangleSetSizeHints(&small, &cli->info->size_hints);
+  CU_ASSERT(small.w == 8 && small.h == 8);
+  NeuroTypeDeleteClient(cli);
+}
+
+static void minimized_clients(void) {
+  // Minimize some fake clients
+  NeuroClient *const cli1 = NeuroTypeNewClient(7UL, NULL);
+  NeuroClient *const cli2 = NeuroTypeNewClient(8UL, NULL);
+  NeuroClient *const cli3 = NeuroTypeNewClient(9UL, NULL);
+  CU_ASSERT(NeuroCorePushMinimizedClient(cli1) == cli1);
+  CU_ASSERT(NeuroCorePushMinimizedClient(cli2) == cli2);
+  CU_ASSERT(NeuroCorePushMinimizedClient(cli3) == cli3);
+  CU_ASSERT(NeuroCoreStackGetMinimizedNum(0U) == 3U);
+  NeuroClientPtrPtr c = NeuroCoreStackGetMinimizedHeadClient(0U);
+  CU_ASSERT(c && NEURO_CLIENT_PTR(c) == cli1);
+  c = NeuroCoreClientGetNext(NeuroCoreClientGetNext(c));
+  CU_ASSERT(c && NEURO_CLIENT_PTR(c) == cli3);
+  CU_ASSERT_PTR_NULL(NeuroCoreClientGetNext(c));
+
+  // Remove one from the middle by window, and pop the others in reverse order
+  CU_ASSERT(NeuroCoreRemoveMinimizedClient(8UL) == cli2);
+  CU_ASSERT(NeuroCorePopMinimizedClient(0U) == cli3);
+  CU_ASSERT(NeuroCorePopMinimizedClient(0U) == cli1);
+  CU_ASSERT_PTR_NULL(NeuroCorePopMinimizedClient(0U));
+  CU_ASSERT(NeuroCoreStackGetMinimizedNum(0U) == 0U);
+
+  // Free the fake clients
+  NeuroTypeDeleteClient(cli1);
+  NeuroTypeDeleteClient(cli2);
+  NeuroTypeDeleteClient(cli3);
+}
+
+static void client_flags(void) {
+  // Create some fake clients
+  NeuroClient *const cli1 = NeuroTypeNewClient(5UL, NULL);
+  NeuroClient *const cli2 = NeuroTypeNewClient(6UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli1);
+  CU_ASSERT_PTR_NOT_NULL(cli2);
+  cli2->fixed_pos = NEURO_FIXED_POSITION_UP;
+  NeuroClientPtrPtr c1 = NeuroCoreAddClientStart(cli1);
+  NeuroClientPtrPtr c2 = NeuroCoreAddClientStart(cli2);
+  CU_ASSERT(NeuroCoreStackGetFlagClient(0U, NEURO_CLIENT_FLAG_FIXED) == c2);
+  CU_ASSERT_PTR_NULL(NeuroCoreStackGetFlagClient(0U, NEURO_CLIENT_FLAG_URGENT));
+
+  // Flags set through the setters are tracked by the stack
+  NeuroCoreClientSetUrgent(c1, true);
+  NeuroCoreClientSetFullscreen(c2, true);
+  CU_ASSERT(NeuroCoreFindFlagClient(NEURO_CLIENT_FLAG_URGENT) == c1);
+  CU_ASSERT(NeuroCoreStackGetFlagNum(0U, NEURO_CLIENT_FLAG_FULLSCREEN) == 1U);
+
+  // Swapped clients keep their flags
+  NeuroCoreClientSwap(c1, c2);
+  CU_ASSERT(NeuroCoreStackGetFlagClient(0U, NEURO_CLIENT_FLAG_URGENT) == c2);
+  CU_ASSERT(NeuroCoreStackGetFlagClient(0U, NEURO_CLIENT_FLAG_FIXED) == c1);
+
+  // Moved clients take their flags to the new stack
+  NeuroCoreMoveClient(c1, 1U);
+  CU_ASSERT(NeuroCoreStackGetFlagNum(0U, NEURO_CLIENT_FLAG_FIXED) == 0U);
+  CU_ASSERT(NeuroCoreStackGetFlagClient(1U, NEURO_CLIENT_FLAG_FULLSCREEN) == c1);
+
+  // Free the fake clients
+  NeuroCoreClientSetUrgent(c2, false);
+  CU_ASSERT_PTR_NULL(NeuroCoreFindFlagClient(NEURO_CLIENT_FLAG_URGENT));
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c1));
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c2));
+  CU_ASSERT_PTR_NULL(NeuroCoreFindFlagClient(NEURO_CLIENT_FLAG_FIXED));
+  CU_ASSERT_PTR_NULL(NeuroCoreFindFlagClient(NEURO_CLIENT_FLAG_FULLSCREEN));
+}
+
+static void spatial_index(void) {
+  // Create a 2x2 grid of fake clients and a free one in the middle
+  const NeuroIndex ws = 2U;
+  const NeuroRectangle regions[] = { { { 0, 0 }, 100, 100 }, { { 100, 0 }, 100, 100 },
+      { { 0, 100 }, 100, 100 }, { { 100, 100 }, 100, 100 }, { { 50, 50 }, 100, 100 } };
+  NeuroClientPtrPtr c[ 5 ];
+  for (NeuroIndex i = 0U; i < 5U; ++i) {
+    NeuroClient *const cli = NeuroTypeNewClient(10UL + i, NULL);
+    CU_ASSERT_PTR_NOT_NULL(cli);
+    cli->ws = ws;
+    if (i == 4U)
+      cli->free_setter_fn = NeuroRuleFreeSetterCenter;
+    c[ i ] = NeuroCoreAddClientEnd(cli);
+    memmove(NeuroCoreClientGetRegion(c[ i ]), regions + i, sizeof(NeuroRectangle));
+  }
+  NeuroCoreStackInvalidateRegions(ws);
+
+  // Nearest clients in each direction
+  CU_ASSERT(NeuroCoreStackFindNearestClient(ws, c[ 3 ], NEURO_DIRECTION_UP) == c[ 1 ]);
+  CU_ASSERT(NeuroCoreStackFindNearestClient(ws, c[ 3 ], NEURO_DIRECTION_LEFT) == c[ 2 ]);
+  CU_ASSERT(NeuroCoreStackFindNearestClient(ws, c[ 0 ], NEURO_DIRECTION_RIGHT) == c[ 1 ]);
+  CU_ASSERT(NeuroCoreStackFindNearestClient(ws, c[ 0 ], NEURO_DIRECTION_DOWN) == c[ 2 ]);
+  CU_ASSERT_PTR_NULL(NeuroCoreStackFindNearestClient(ws, c[ 0 ], NEURO_DIRECTION_UP));
+
+  // The topmost client in the stacking order wins, the last added client is on top
+  const NeuroPoint p1 = { 120, 120 }, p2 = { 180, 180 }, p3 = { 500, 500 };
+  NeuroCoreSetCurrClient(c[ 0 ]);
+  CU_ASSERT(NeuroCoreStackFindPointedClient(ws, &p1) == c[ 4 ]);
+  CU_ASSERT(NeuroCoreStackFindPointedClient(ws, &p2) == c[ 3 ]);
+  CU_ASSERT_PTR_NULL(NeuroCoreStackFindPointedClient(ws, &p3));
+
+  // Of two overlapping free clients, neither of them current, the raised one wins
+  NeuroCoreClientSetFreeSetter(c[ 3 ], NeuroRuleFreeSetterCenter);
+  CU_ASSERT(NeuroCoreStackFindPointedClient(ws, &p1) == c[ 4 ]);
+  NeuroCoreClientRaise(c[ 3 ]);
+  CU_ASSERT(NeuroCoreStackFindPointedClient(ws, &p1) == c[ 3 ]);
+  NeuroCoreClientRaise(c[ 4 ]);
+  CU_ASSERT(NeuroCoreStackFindPointedClient(ws, &p1) == c[ 4 ]);
+
+  // Free the fake clients
+  for (NeuroIndex i = 0U; i < 5U; ++i)
+    NeuroTypeDeleteClient(NeuroCoreRemoveClient(c[ i ]));
+  CU_ASSERT_PTR_NULL(NeuroCoreStackFindPointedClient(ws, &p2));
+}
+
+static bool is_not_window_42(const NeuroClientPtrPtr c, const void *data) {
+  (void)data;
+  return NEURO_CLIENT_PTR(c)->win != 42UL;
+}
+
+static void region_handles(void) {
+  // Regions live in the arrays of the stack, starting at the float region of the client
+  NeuroClient *const cli1 = NeuroTypeNewClient(41UL, NULL);
+  NeuroClient *const cli2 = NeuroTypeNewClient(42UL, NULL);
+  NeuroClient *const cli3 = NeuroTypeNewClient(43UL, NULL);
+  cli1->ws = cli2->ws = cli3->ws = 3U;
+  NeuroClientPtrPtr c1 = NeuroCoreAddClientEnd(cli1);
+  NeuroClientPtrPtr c2 = NeuroCoreAddClientEnd(cli2);
+  NeuroClientPtrPtr c3 = NeuroCoreAddClientEnd(cli3);
+  CU_ASSERT(NeuroCoreClientGetRegion(c1)->w == cli1->float_region.w);
+  NeuroCoreClientGetRegion(c1)->w = 10;
+  NeuroCoreClientGetRegion(c2)->w = 20;
+  NeuroCoreClientGetRegion(c3)->w = 30;
+
+  // The tested clients are gathered in stack order and arranged in place
+  NeuroArrange *const a = NeuroCoreStackGatherRegions(3U, is_not_window_42);
+  CU_ASSERT_PTR_NOT_NULL(a);
+  CU_ASSERT(a->size == 2U);
+  CU_ASSERT(a->client_regions[ 0 ].w == 10);
+  CU_ASSERT(a->client_regions[ 1 ].w == 30);
+  a->client_regions[ 1 ].w = 33;
+  CU_ASSERT(NeuroCoreClientGetRegion(c3)->w == 33);
+  CU_ASSERT(NeuroCoreClientGetRegion(c2)->w == 20);
+
+  // Removing a client keeps the regions of the rest, and gives the float region back to the client
+  NeuroCoreClientGetFloatRegion(c1)->w = 123;
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c2));
+  NeuroClient *const removed = NeuroCoreRemoveClient(c1);
+  CU_ASSERT(removed->float_region.w == 123);
+  NeuroTypeDeleteClient(removed);
+  CU_ASSERT(NeuroCoreClientGetRegion(c3)->w == 33);
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c3));
+}
+
+static void stacking_order(void) {
+  // New clients go on top and leave the stacking order dirty
+  NeuroClient *const cli1 = NeuroTypeNewClient(31UL, NULL);
+  NeuroClient *const cli2 = NeuroTypeNewClient(32UL, NULL);
+  NeuroClient *const cli3 = NeuroTypeNewClient(33UL, NULL);
+  cli1->ws = cli2->ws = cli3->ws = 3U;
+  NeuroClientPtrPtr c1 = NeuroCoreAddClientEnd(cli1);
+  NeuroClientPtrPtr c2 = NeuroCoreAddClientEnd(cli2);
+  NeuroClientPtrPtr c3 = NeuroCoreAddClientEnd(cli3);
+  CU_ASSERT(NeuroCoreStackIsStackingDirty(3U));
+  CU_ASSERT(NeuroCoreStackGetTopClient(3U) == c3);
+  CU_ASSERT(NeuroCoreClientGetBelow(c3) == c2);
+  CU_ASSERT(NeuroCoreClientGetBelow(c2) == c1);
+  CU_ASSERT_PTR_NULL(NeuroCoreClientGetBelow(c1));
+
+  // Raising and removing keep the rest of the order
+  NeuroCoreStackSetStackingDirty(3U, false);
+  NeuroCoreClientRaise(c1);
+  CU_ASSERT(NeuroCoreStackGetTopClient(3U) == c1);
+  CU_ASSERT(NeuroCoreClientGetBelow(c1) == c3);
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c3));
+  CU_ASSERT(NeuroCoreClientGetBelow(c1) == c2);
+  CU_ASSERT(!NeuroCoreStackIsStackingDirty(3U));
+
+  // Free the fake clients
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c1));
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c2));
+  CU_ASSERT_PTR_NULL(NeuroCoreStackGetTopClient(3U));
+}
+
+static void deferred_layout(void) {
+  // The layout of a hidden stack is skipped
+  static const int gaps[ 4 ] = { 0, 0, 0, 0 };
+  static const NeuroMonitor m = { "Test", 4U, gaps, { { 0, 0 }, 800, 600 }, 60, NULL };
+  NeuroClient *const cli = NeuroTypeNewClient(51UL, NULL);
+  cli->ws = 4U;
+  NeuroClientPtrPtr c = NeuroCoreAddClientEnd(cli);
+  NeuroCoreClientGetRegion(c)->w = 1;
+  NeuroLayoutRunCurr(4U);
+  CU_ASSERT(NeuroCoreClientGetRegion(c)->w == 1);
+  CU_ASSERT(!NeuroCoreStackIsLayoutDirty(4U));
+
+  // It is performed once the stack gets a monitor
+  NeuroCoreStackSetMonitor(4U, &m);
+  CU_ASSERT(NeuroCoreStackIsLayoutDirty(4U));
+  NeuroLayoutRunCurr(4U);
+  CU_ASSERT(NeuroCoreClientGetRegion(c)->w == m.region.w);
+  CU_ASSERT(!NeuroCoreStackIsLayoutDirty(4U));
+
+  // Getting the same monitor back does not need another layout, a change while hidden does
+  NeuroCoreStackSetMonitor(4U, NULL);
+  NeuroCoreStackSetMonitor(4U, &m);
+  CU_ASSERT(!NeuroCoreStackIsLayoutDirty(4U));
+  NeuroCoreStackSetMonitor(4U, NULL);
+  NeuroLayoutRunCurr(4U);
+  NeuroCoreStackSetMonitor(4U, &m);
+  CU_ASSERT(NeuroCoreStackIsLayoutDirty(4U));
+
+  // Leave the stack hidden, as the rest of the tests expect
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+  NeuroCoreStackSetMonitor(4U, NULL);
+  CU_ASSERT(NeuroCoreStackGetRegion(4U)->p.x == NeuroSystemGetHiddenRegion()->p.x);
+}
+
+static void enter_notify_serial(void) {
+  // Only the crossings caused by requests sent before the recorded serial are ignored
+  NeuroSystemIgnoreEnterNotifyBefore(100UL);
+  CU_ASSERT(NeuroSystemIsEnterNotifyIgnored(99UL));
+  CU_ASSERT(!NeuroSystemIsEnterNotifyIgnored(100UL));
+  CU_ASSERT(!NeuroSystemIsEnterNotifyIgnored(101UL));
+
+  // Serials wrap around
+  NeuroSystemIgnoreEnterNotifyBefore(2UL);
+  CU_ASSERT(NeuroSystemIsEnterNotifyIgnored((unsigned long)-1));
+  CU_ASSERT(!NeuroSystemIsEnterNotifyIgnored(2UL));
+  NeuroSystemIgnoreEnterNotifyBefore(0UL);
+}
+
 static void set_curr_stack(void) {
   NeuroCoreSetCurrStack(1);
   CU_ASSERT(NeuroCoreGetCurrStack() == 1);
@@ -85,6 +443,17 @@ int main(int argc, const char *const *argv) {
 
   // Add the tests to the suite
   if ((NULL == CU_add_test(core_suite, "add_remove_client()", add_remove_client)) ||
+      (NULL == CU_add_test(core_suite, "find_window_client()", find_window_client)) ||
+      (NULL == CU_add_test(core_suite, "move_client_pool()", move_client_pool)) ||
+      (NULL == CU_add_test(core_suite, "client_info()", client_info)) ||
+      (NULL == CU_add_test(core_suite, "size_hints()", size_hints)) ||
+      (NULL == CU_add_test(core_suite, "minimized_clients()", minimized_clients)) ||
+      (NULL == CU_add_test(core_suite, "client_flags()", client_flags)) ||
+      (NULL == CU_add_test(core_suite, "spatial_index()", spatial_index)) ||
+      (NULL == CU_add_test(core_suite, "region_handles()", region_handles)) ||
+      (NULL == CU_add_test(core_suite, "stacking_order()", stacking_order)) ||
+      (NULL == CU_add_test(core_suite, "deferred_layout()", deferred_layout)) ||
+      (NULL == CU_add_test(core_suite, "enter_notify_serial()", enter_notify_serial)) ||
       (NULL == CU_add_test(core_suite, "set_curr_stack()", set_curr_stack))) {
     CU_cleanup_registry();
     return CU_get_error();